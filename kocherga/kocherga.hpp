@@ -10,7 +10,9 @@
 #include <cstdint>
 #include <cstring>
 #include <optional>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 #define KOCHERGA_VERSION_MAJOR 2  // NOLINT NOSONAR
 #define KOCHERGA_VERSION_MINOR 1  // NOLINT NOSONAR
@@ -133,6 +135,18 @@ public:
     /// Hence, the bootloader core knows what response it is by checking which request was sent last.
     virtual void processResponse(const std::size_t response_length, const std::uint8_t* const response) = 0;
 
+    /// Returns the capacity and the pointer of a buffer where the node may reassemble the response to the pending
+    /// request in place as it is being received, and then pass the same pointer to processResponse().
+    /// This eliminates intermediate copies on transports where the response is received in fragments (e.g., CAN).
+    /// The buffer is large enough to accommodate any response the bootloader may request;
+    /// its contents may be altered by the node at any time until processResponse() is invoked.
+    [[nodiscard]] virtual auto getResponseBuffer() -> std::pair<std::size_t, std::uint8_t*> = 0;
+
+    /// If the response produced by the last processRequest() was served from a cache, returns a tag that changes
+    /// whenever the cached content changes; otherwise, returns an empty option, which is also the default.
+    /// The node may then keep the transfer CRC of the response instead of recomputing it for every request.
+    [[nodiscard]] virtual auto getLastResponseTag() const -> std::optional<std::uint32_t> { return {}; }
+
     virtual ~IReactor()                          = default;
     IReactor()                                   = default;
     IReactor(const IReactor&)                    = delete;
@@ -166,6 +180,19 @@ public:
                                            const std::size_t         payload_length,
                                            const std::uint8_t* const payload) -> bool = 0;
 
+    /// Send the same request as the last sendRequest() again under a new transfer-ID; e.g., after a response timeout.
+    /// All arguments except the transfer-ID are the same as in the last sendRequest(), which allows the node to reuse
+    /// the transfer-ID-independent state computed when the request was first encoded, such as the transfer CRC.
+    /// By default, this is equivalent to sendRequest().
+    [[nodiscard]] virtual auto resendRequest(const ServiceID           service_id,
+                                             const NodeID              server_node_id,
+                                             const TransferID          transfer_id,
+                                             const std::size_t         payload_length,
+                                             const std::uint8_t* const payload) -> bool
+    {
+        return sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
     /// Cancel the request that was previously set pending by sendRequest(); no longer expect the response.
     /// This method is invoked when the request has timed out.
     virtual void cancelRequest() = 0;
@@ -177,6 +204,13 @@ public:
                                               const std::size_t         payload_length,
                                               const std::uint8_t* const payload) -> bool = 0;
 
+    /// The earliest uptime when poll() needs to be invoked again, unless an I/O event occurs earlier.
+    /// The deadline may be in the past, meaning that the node should be polled immediately.
+    /// An empty option means that the node has no internal deadlines and needs to be polled only upon I/O events.
+    /// The default implementation returns an empty option; the node is then still polled at least once per
+    /// heartbeat period because the bootloader itself never sleeps longer than that.
+    [[nodiscard]] virtual auto getNextDeadline() const -> std::optional<std::chrono::microseconds> { return {}; }
+
     virtual ~INode()                       = default;
     INode()                                = default;
     INode(const INode&)                    = delete;
@@ -187,6 +221,213 @@ public:
 
 // --------------------------------------------------------------------------------------------------------------------
 
+/// A set of up to Capacity nodes registered at runtime using add(). The calls to the nodes are dispatched dynamically.
+/// Lifetime of the nodes is managed outside of the set.
+template <std::uint8_t Capacity>
+class DynamicNodeSet final
+{
+public:
+    static_assert(Capacity > 0, "At least one node is required");
+
+    /// The return value is true on success, false if the set is full or this node is already registered.
+    [[nodiscard]] auto add(INode* const node) -> bool
+    {
+        if ((node == nullptr) || (size_ >= Capacity))
+        {
+            return false;
+        }
+        for (std::uint8_t i = 0U; i < size_; i++)
+        {
+            if (nodes_.at(i) == node)
+            {
+                return false;  // This node is already registered.
+            }
+        }
+        nodes_.at(size_) = node;
+        size_++;
+        return true;
+    }
+
+    [[nodiscard]] auto size() const -> std::uint8_t { return size_; }
+
+    /// Nullptr if there is no such node.
+    [[nodiscard]] auto at(const std::uint8_t index) const -> INode*
+    {
+        return (index < size_) ? nodes_.at(index) : nullptr;
+    }
+
+    /// Invokes fun(INode&) for each registered node in the order of registration.
+    template <typename F>
+    void forEach(F&& fun) const
+    {
+        for (std::uint8_t i = 0U; i < size_; i++)
+        {
+            fun(*nodes_.at(i));
+        }
+    }
+
+    /// Invokes fun(INode&) for the node at the specified index. The index shall be valid.
+    template <typename F>
+    void visit(const std::uint8_t index, F&& fun) const
+    {
+        KOCHERGA_ASSERT(index < size_);
+        fun(*nodes_.at(index));
+    }
+
+private:
+    std::array<INode*, Capacity> nodes_{};
+    std::uint8_t                 size_ = 0;
+};
+
+namespace detail
+{
+/// Recursive storage of the nodes of StaticNodeSet. Each level holds one node by value.
+template <std::uint8_t Index, typename... Nodes>
+class NodeHolder
+{
+public:
+    template <typename F>
+    void forEach(F&&)
+    {}
+
+    template <typename F>
+    void forEach(F&&) const
+    {}
+
+    template <typename F>
+    void visit(const std::uint8_t, F&&)
+    {}
+
+    [[nodiscard]] auto at(const std::uint8_t) -> INode* { return nullptr; }
+};
+
+template <std::uint8_t Index, typename Head, typename... Tail>
+class NodeHolder<Index, Head, Tail...> : public NodeHolder<Index + 1U, Tail...>
+{
+    using Base = NodeHolder<Index + 1U, Tail...>;
+
+public:
+    static_assert(std::is_base_of_v<INode, Head>, "Nodes shall implement INode");
+
+    NodeHolder() = default;
+
+    /// Each node is constructed in place from its own tuple of arguments, so the nodes need not be movable.
+    template <typename HeadArgs, typename... TailArgs>
+    explicit NodeHolder(HeadArgs&& head_args, TailArgs&&... tail_args) :
+        Base(std::forward<TailArgs>(tail_args)...), node_(std::make_from_tuple<Head>(std::forward<HeadArgs>(head_args)))
+    {}
+
+    template <typename F>
+    void forEach(F&& fun)
+    {
+        fun(asINode());
+        Base::forEach(fun);
+    }
+
+    template <typename F>
+    void forEach(F&& fun) const
+    {
+        fun(static_cast<const INode&>(node_));
+        Base::forEach(fun);
+    }
+
+    template <typename F>
+    void visit(const std::uint8_t index, F&& fun)
+    {
+        if (index == Index)
+        {
+            fun(asINode());
+        }
+        else
+        {
+            Base::visit(index, fun);
+        }
+    }
+
+    [[nodiscard]] auto at(const std::uint8_t index) -> INode* { return (index == Index) ? &node_ : Base::at(index); }
+
+    template <std::uint8_t I>
+    [[nodiscard]] auto get() -> auto&
+    {
+        if constexpr (I == Index)
+        {
+            return node_;
+        }
+        else
+        {
+            return Base::template get<I>();
+        }
+    }
+
+private:
+    /// The node implementations usually keep the overrides private, hence the calls are made via INode.
+    /// The referent is a complete object of a known type, which allows the compiler to devirtualize the calls.
+    [[nodiscard]] auto asINode() -> INode& { return node_; }
+
+    Head node_;
+};
+}  // namespace detail
+
+/// A fixed set of nodes of the specified types that are stored by value. Unlike DynamicNodeSet, the node types are
+/// known at compile time, so the compiler can dispatch the calls to the nodes statically and inline them.
+/// The nodes are constructed either by default or from one argument tuple per node
+/// (see std::forward_as_tuple()) in the order of the template parameters.
+template <typename... Nodes>
+class StaticNodeSet final
+{
+public:
+    static_assert(sizeof...(Nodes) > 0, "At least one node is required");
+    static_assert(sizeof...(Nodes) <= std::numeric_limits<std::uint8_t>::max(), "Too many nodes");
+
+    StaticNodeSet() = default;
+
+    template <typename... ArgTuples>
+    explicit StaticNodeSet(ArgTuples&&... node_args) : nodes_(std::forward<ArgTuples>(node_args)...)
+    {
+        static_assert(sizeof...(ArgTuples) == sizeof...(Nodes), "One argument tuple per node is expected");
+    }
+
+    [[nodiscard]] static constexpr auto size() -> std::uint8_t { return sizeof...(Nodes); }
+
+    /// Nullptr if there is no such node.
+    [[nodiscard]] auto at(const std::uint8_t index) -> INode* { return nodes_.at(index); }
+
+    /// Typed access to the node at the specified index.
+    template <std::uint8_t I>
+    [[nodiscard]] auto get() -> auto&
+    {
+        static_assert(I < sizeof...(Nodes), "No such node");
+        return nodes_.template get<I>();
+    }
+
+    /// Invokes fun(INode&) for each node in the order of the template parameters.
+    template <typename F>
+    void forEach(F&& fun)
+    {
+        nodes_.forEach(std::forward<F>(fun));
+    }
+
+    /// Invokes fun(const INode&) for each node in the order of the template parameters.
+    template <typename F>
+    void forEach(F&& fun) const
+    {
+        nodes_.forEach(std::forward<F>(fun));
+    }
+
+    /// Invokes fun(INode&) for the node at the specified index. The index shall be valid.
+    template <typename F>
+    void visit(const std::uint8_t index, F&& fun)
+    {
+        KOCHERGA_ASSERT(index < size());
+        nodes_.visit(index, std::forward<F>(fun));
+    }
+
+private:
+    detail::NodeHolder<0, Nodes...> nodes_;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
 /// This interface abstracts the target-specific ROM routines.
 /// App update scenario:
 ///  1. beginWrite()
@@ -331,15 +572,83 @@ public:
         };
     }
 
+    /// Processes the block a nibble at a time using a 64-byte table, which is several times faster than
+    /// the bitwise single-byte update while keeping the ROM footprint negligible.
+    void update(const std::size_t size, const std::uint8_t* const ptr) noexcept
+    {
+        const auto*   p = ptr;
+        std::uint32_t x = value_;  // A local copy because the byte pointer may alias the state.
+        for (std::size_t s = 0; s < size; s++)
+        {
+            x ^= static_cast<std::uint32_t>(*p);
+            x = (x >> NibbleWidth) ^ NibbleTable[x & NibbleMask];  // NOLINT bounds are ensured by the mask
+            x = (x >> NibbleWidth) ^ NibbleTable[x & NibbleMask];  // NOLINT bounds are ensured by the mask
+            p++;
+        }
+        value_ = x;
+    }
+
     [[nodiscard]] auto isResidueCorrect() const noexcept { return value_ == Residue; }
 
 private:
     static constexpr std::uint32_t Xor           = 0xFFFF'FFFFUL;
     static constexpr std::uint32_t ReflectedPoly = 0x82F6'3B78UL;
     static constexpr std::uint32_t Residue       = 0xB798'B438UL;
+    static constexpr std::uint32_t NibbleWidth   = 4U;
+    static constexpr std::uint32_t NibbleMask    = (1U << NibbleWidth) - 1U;
+
+    static constexpr auto NibbleTable = []() {
+        std::array<std::uint32_t, NibbleMask + 1U> out{};
+        for (std::uint32_t i = 0; i < out.size(); i++)
+        {
+            std::uint32_t x = i;
+            for (auto k = 0U; k < NibbleWidth; k++)
+            {
+                x = ((x & 1U) != 0) ? ((x >> 1U) ^ ReflectedPoly) : (x >> 1U);  // NOLINT
+            }
+            out.at(i) = x;
+        }
+        return out;
+    }();
 
     std::uint32_t value_ = Xor;
 };
+
+/// Keeps the transfer CRC of the last response that the reactor served from its cache (see getLastResponseTag()),
+/// so that the CRC of a large constant response like GetInfo is computed once rather than per request.
+template <typename CRC>
+class ResponseCRCCache
+{
+public:
+    /// Shall be invoked right after IReactor::processRequest(); returns an empty option if the response is not cached.
+    [[nodiscard]] auto update(const IReactor&           reactor,
+                              const PortID              service_id,
+                              const std::size_t         payload_length,
+                              const std::uint8_t* const payload) -> std::optional<CRC>
+    {
+        const auto tag = reactor.getLastResponseTag();
+        if (!tag)
+        {
+            return {};
+        }
+        if ((!entry_) || (entry_->service_id != service_id) || (entry_->tag != *tag))
+        {
+            CRC crc;
+            crc.update(payload_length, payload);
+            entry_ = Entry{service_id, *tag, crc};
+        }
+        return entry_->crc;
+    }
+
+private:
+    struct Entry
+    {
+        PortID        service_id{};
+        std::uint32_t tag{};
+        CRC           crc;
+    };
+    std::optional<Entry> entry_;
+};
 }  // namespace detail
 
 /// This is used to verify integrity of the application and other data.
@@ -560,6 +869,16 @@ struct Heartbeat
     };
 };
 
+struct NodeGetInfo
+{
+    static constexpr std::size_t CertificateOfAuthenticityCapacity = 255;
+
+    /// Protocol and hardware versions, software version and VCS revision, unique-ID, name,
+    /// optional software image CRC, certificate of authenticity.
+    static constexpr std::size_t ResponseSizeMax =
+        (2 + 2) + (2 + 8) + 16 + (1 + NameCapacity) + (1 + 8) + (1 + CertificateOfAuthenticityCapacity);
+};
+
 struct ExecuteCommand
 {
     static constexpr std::size_t ResponseSize   = 7;
@@ -598,6 +917,7 @@ struct File
     static constexpr std::size_t ReadRequestCapacity      = PathCapacity + 6;
     static constexpr std::size_t ReadResponseSizeMin      = 4;
     static constexpr std::size_t ReadResponseDataCapacity = 256;
+    static constexpr std::size_t ReadResponseSizeMax      = ReadResponseSizeMin + ReadResponseDataCapacity;
 
     /// If the server returned an error, data will be nullptr and the data length will be zero.
     struct ReadResponse
@@ -643,8 +963,18 @@ public:
 };
 
 /// Unifies multiple INode and performs DSDL serialization. Manages the network at the presentation layer.
-class Presenter final : public IReactor
+/// The nodes are kept in the NodeSet, which is either DynamicNodeSet or StaticNodeSet.
+template <typename NodeSet>
+class BasicPresenter final : public IReactor
 {
+    static constexpr std::size_t MaxDecimalDigits            = 10;  // Of std::uint32_t.
+    static constexpr std::size_t LogRepetitionSuffixCapacity = MaxDecimalDigits + 4;
+
+    /// The log budget is kept in bytes multiplied by this scale to avoid accumulating rounding errors:
+    /// one microsecond of elapsed time adds log_bandwidth units. The bucket holds at most one longest record.
+    static constexpr std::uint64_t LogBudgetScale = 1'000'000;
+    static constexpr std::uint64_t LogBudgetMax   = dsdl::Diagnostic::RecordSize * LogBudgetScale;
+
     struct FileLocationSpecifier final
     {
         std::uint8_t                                       local_node_index{};
@@ -665,38 +995,37 @@ public:
     struct Params final
     {
         std::uint8_t request_retry_limit;
+
+        /// Bytes of serialized diagnostic records per second; zero disables the limit.
+        /// The same records are published via every node, so this is effectively the budget of each node.
+        std::uint32_t log_bandwidth;
     };
 
-    Presenter(const SystemInfo& system_info, IController& controller, const Params& param) :
-        par_(param), system_info_(system_info), controller_(controller)
+    /// The node arguments, if any, are forwarded to the constructor of the node set.
+    template <typename... NodeArgs>
+    BasicPresenter(const SystemInfo& system_info,
+                   IController&      controller,
+                   const Params&     param,
+                   NodeArgs&&... node_args) :
+        par_(param),
+        system_info_(system_info),
+        nodes_(std::forward<NodeArgs>(node_args)...),
+        controller_(controller)
     {}
 
-    [[nodiscard]] auto addNode(INode* const node) -> bool
-    {
-        for (const auto* const n : nodes_)
-        {
-            if (n == node)
-            {
-                return false;  // This node is already registered.
-            }
-        }
-        if (num_nodes_ < nodes_.size())
-        {
-            nodes_.at(num_nodes_) = node;
-            num_nodes_++;
-            return true;
-        }
-        return false;
-    }
+    /// Only available with DynamicNodeSet.
+    [[nodiscard]] auto addNode(INode* const node) -> bool { return nodes_.add(node); }
+
+    [[nodiscard]] auto getNumberOfNodes() const -> std::uint8_t { return nodes_.size(); }
 
-    [[nodiscard]] auto getNumberOfNodes() const -> std::uint8_t { return num_nodes_; }
+    [[nodiscard]] auto getNodes() -> NodeSet& { return nodes_; }
 
     [[nodiscard]] auto trigger(const INode* const        node,
                                const NodeID              file_server_node_id,
                                const std::size_t         app_image_file_path_length,
                                const std::uint8_t* const app_image_file_path) -> bool
     {
-        for (std::uint8_t i = 0U; i < num_nodes_; i++)
+        for (std::uint8_t i = 0U; i < nodes_.size(); i++)
         {
             if (nodes_.at(i) == node)
             {
@@ -712,7 +1041,7 @@ public:
                                const std::size_t         app_image_file_path_length,
                                const std::uint8_t* const app_image_file_path) -> bool
     {
-        if (node_index < num_nodes_)
+        if (node_index < nodes_.size())
         {
             beginUpdate(node_index, file_server_node_id, app_image_file_path_length, app_image_file_path);
             return true;
@@ -722,17 +1051,18 @@ public:
 
     void poll(const std::chrono::microseconds uptime)
     {
+        if (uptime > last_poll_at_)
+        {
+            const auto elapsed = std::min(static_cast<std::uint64_t>((uptime - last_poll_at_).count()), LogBudgetMax);
+            log_budget_        = std::min(log_budget_ + (elapsed * par_.log_bandwidth), LogBudgetMax);
+        }
         last_poll_at_ = uptime;
 
         current_node_index_ = 0;
-        for (INode* const node : nodes_)
-        {
-            if (node != nullptr)
-            {
-                node->poll(*this, uptime);
-            }
+        nodes_.forEach([this, uptime](INode& node) {
+            node.poll(*this, uptime);
             ++current_node_index_;
-        }
+        });
 
         if (file_loc_spec_)
         {
@@ -743,11 +1073,11 @@ public:
                 {
                     fls.pending->remaining_attempts--;
                     fls.pending->response_deadline = uptime + ServiceResponseTimeout;
-                    (void) sendFileReadRequest(fls);  // Ignore the result, we will retry later if possible.
+                    (void) resendFileReadRequest(fls);  // Ignore the result, we will retry later if possible.
                 }
                 else
                 {
-                    nodes_.at(fls.local_node_index)->cancelRequest();
+                    nodes_.visit(fls.local_node_index, [](INode& node) { node.cancelRequest(); });
                     fls.pending.reset();
                     controller_.handleFileReadResult({});
                 }
@@ -761,7 +1091,46 @@ public:
         }
     }
 
+    /// The earliest uptime when poll() needs to be invoked again, unless an I/O event occurs earlier.
+    /// Accounts for the heartbeat, the file read request timeout, and the deadlines reported by the nodes.
+    [[nodiscard]] auto getNextDeadline() const -> std::chrono::microseconds
+    {
+        auto out = next_heartbeat_deadline_;
+        if (file_loc_spec_ && file_loc_spec_->pending)
+        {
+            // The timeout is detected when the response deadline is exceeded, hence the extra microsecond.
+            out = std::min(out, file_loc_spec_->pending->response_deadline + std::chrono::microseconds{1});
+        }
+        nodes_.forEach([&out](const INode& node) {
+            if (const auto dl = node.getNextDeadline())
+            {
+                out = std::min(out, *dl);
+            }
+        });
+        return out;
+    }
+
+    /// The uptime when the log budget will suffice for any record, assuming that nothing else is published meanwhile.
+    [[nodiscard]] auto getLogBudgetDeadline() const -> std::chrono::microseconds
+    {
+        if ((par_.log_bandwidth == 0) || (log_budget_ >= LogBudgetMax))
+        {
+            return last_poll_at_;
+        }
+        const std::uint64_t deficit = LogBudgetMax - log_budget_;
+        const auto          delay   = (deficit + par_.log_bandwidth - 1U) / par_.log_bandwidth;
+        return last_poll_at_ + std::chrono::microseconds{static_cast<std::int64_t>(delay)};
+    }
+
     void setNodeHealth(const dsdl::Heartbeat::Health value) { node_health_ = value; }
+
+    /// The GetInfo response is cached; this shall be invoked whenever the application info may have changed.
+    void invalidateNodeInfo()
+    {
+        node_info_size_ = 0;
+        node_info_tag_++;
+    }
+
     void setNodeVSSC(const std::uint8_t value) { node_vssc_ = value; }
 
     /// The timeout and retries will be managed by the presenter automatically.
@@ -770,7 +1139,7 @@ public:
     {
         if (file_loc_spec_)
         {
-            FileLocationSpecifier::Pending pend{};
+            typename FileLocationSpecifier::Pending pend{};
             pend.offset             = offset;
             pend.response_deadline  = last_poll_at_ + ServiceResponseTimeout;
             pend.remaining_attempts = par_.request_retry_limit;
@@ -785,14 +1154,26 @@ public:
         return false;
     }
 
-    void publishLogRecord(const dsdl::Diagnostic::Severity severity, const char* const text)
+    /// If the repetition count is greater than one, it is appended to the text like " (x3)"; the text is truncated
+    /// if necessary to fit the suffix. Returns false if the record does not fit into the bandwidth budget;
+    /// in this case nothing is published and the caller should try again later.
+    [[nodiscard]] auto publishLogRecord(const dsdl::Diagnostic::Severity severity,
+                                        const char* const                text,
+                                        const std::uint32_t              repetitions = 1) -> bool
     {
+        std::array<std::uint8_t, LogRepetitionSuffixCapacity> suffix{};
+        std::size_t                                           suffix_length = 0;
+        if (repetitions > 1)
+        {
+            suffix_length = formatRepetitionSuffix(repetitions, suffix);
+        }
         std::array<std::uint8_t, dsdl::Diagnostic::RecordSize> buf{};
         buf[7]                        = static_cast<std::uint8_t>(severity);
-        std::uint8_t      text_length = 0;
+        std::size_t       text_length = 0;
         const char*       ch          = text;
-        const auto* const buf_end     = std::end(buf);
-        for (auto it = std::begin(buf) + 9; it != buf_end; ++it)  // NOLINT
+        const auto* const buf_end     = std::end(buf) - suffix_length;  // NOLINT
+        auto*             it          = std::begin(buf) + 9;            // NOLINT
+        for (; it != buf_end; ++it)
         {
             if ('\0' == *ch)
             {
@@ -801,16 +1182,19 @@ public:
             *it = static_cast<std::uint8_t>(*ch++);
             ++text_length;
         }
-        buf[8] = text_length;
-        for (INode* const node : nodes_)
+        (void) std::memcpy(it, suffix.data(), suffix_length);
+        text_length += suffix_length;
+        buf[8] = static_cast<std::uint8_t>(text_length);
+        if (!consumeLogBudget(text_length + 9U))
         {
-            if (node != nullptr)
-            {
-                // Ignore transient errors.
-                (void) node->publishMessage(SubjectID::DiagnosticRecord, tid_log_record_, text_length + 9U, buf.data());
-            }
+            return false;
         }
+        nodes_.forEach([this, text_length, &buf](INode& node) {
+            // Ignore transient errors.
+            (void) node.publishMessage(SubjectID::DiagnosticRecord, tid_log_record_, text_length + 9U, buf.data());
+        });
         ++tid_log_record_;
+        return true;
     }
 
 private:
@@ -821,6 +1205,7 @@ private:
                                       std::uint8_t* const       out_response) -> std::optional<std::size_t> override
     {
         std::optional<std::size_t> out;
+        last_response_cached_ = false;
         switch (service_id)
         {
         case static_cast<PortID>(ServiceID::NodeExecuteCommand):
@@ -830,7 +1215,8 @@ private:
         }
         case static_cast<PortID>(ServiceID::NodeGetInfo):
         {
-            out = processNodeInfoRequest(out_response);
+            out                   = processNodeInfoRequest(out_response);
+            last_response_cached_ = true;
             break;
         }
         case static_cast<PortID>(ServiceID::FileRead):
@@ -878,7 +1264,19 @@ private:
         return dsdl::ExecuteCommand::ResponseSize;
     }
 
-    [[nodiscard]] auto processNodeInfoRequest(std::uint8_t* const out_response) const -> std::size_t
+    /// The response is serialized once and then served from the cache until invalidateNodeInfo() is called.
+    [[nodiscard]] auto processNodeInfoRequest(std::uint8_t* const out_response) -> std::size_t
+    {
+        if (node_info_size_ == 0)
+        {
+            node_info_size_ = serializeNodeInfo(node_info_.data());
+            KOCHERGA_ASSERT(node_info_size_ <= node_info_.size());
+        }
+        (void) std::memcpy(out_response, node_info_.data(), node_info_size_);
+        return node_info_size_;
+    }
+
+    [[nodiscard]] auto serializeNodeInfo(std::uint8_t* const out_response) const -> std::size_t
     {
         const auto  app_info = controller_.getAppInfo();
         auto* const base_ptr = out_response;
@@ -913,6 +1311,7 @@ private:
         }
         auto&       name_length = *ptr++;
         const char* ch          = system_info_.node_name;
+        name_length             = 0;  // The output buffer may contain an older response.
         for (auto i = 0U; i < dsdl::NameCapacity; i++)
         {
             if ('\0' == *ch)
@@ -963,7 +1362,8 @@ private:
                         reinterpret_cast<const std::byte*>(&response[4]),
                     };
                 }
-                if (argument && (argument->data_length > dsdl::File::ReadResponseDataCapacity))
+                if (argument && ((argument->data_length > dsdl::File::ReadResponseDataCapacity) ||
+                                 (argument->data_length > (response_length - dsdl::File::ReadResponseSizeMin))))
                 {
                     argument.reset();
                 }
@@ -972,6 +1372,16 @@ private:
         }
     }
 
+    [[nodiscard]] auto getResponseBuffer() -> std::pair<std::size_t, std::uint8_t*> override
+    {
+        return {response_buffer_.size(), response_buffer_.data()};
+    }
+
+    [[nodiscard]] auto getLastResponseTag() const -> std::optional<std::uint32_t> override
+    {
+        return last_response_cached_ ? std::optional<std::uint32_t>(node_info_tag_) : std::nullopt;
+    }
+
     void publishHeartbeat(const std::chrono::microseconds uptime)
     {
         const auto ut = static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(uptime).count());
@@ -984,22 +1394,56 @@ private:
             static_cast<std::uint8_t>(dsdl::Heartbeat::ModeSoftwareUpdate),
             static_cast<std::uint8_t>(node_vssc_),
         }};
-        for (INode* const node : nodes_)
+        nodes_.forEach([this, &buf](INode& node) {
+            // Ignore transient errors.
+            (void) node.publishMessage(SubjectID::NodeHeartbeat, tid_heartbeat_, buf.size(), buf.data());
+        });
+        ++tid_heartbeat_;
+    }
+
+    /// Formats the suffix like " (x123)" and returns its length.
+    static auto formatRepetitionSuffix(std::uint32_t                                          repetitions,
+                                       std::array<std::uint8_t, LogRepetitionSuffixCapacity>& out) -> std::size_t
+    {
+        static constexpr std::uint32_t             Radix = 10;
+        std::array<std::uint8_t, MaxDecimalDigits> digits{};
+        std::size_t                                num_digits = 0;
+        do
         {
-            if (node != nullptr)
-            {
-                // Ignore transient errors.
-                (void) node->publishMessage(SubjectID::NodeHeartbeat, tid_heartbeat_, buf.size(), buf.data());
-            }
+            digits.at(num_digits++) = static_cast<std::uint8_t>('0' + (repetitions % Radix));
+            repetitions /= Radix;
+        } while (repetitions > 0);
+        auto* it = out.begin();
+        *it++    = static_cast<std::uint8_t>(' ');
+        *it++    = static_cast<std::uint8_t>('(');
+        *it++    = static_cast<std::uint8_t>('x');
+        while (num_digits > 0)
+        {
+            *it++ = digits.at(--num_digits);
         }
-        ++tid_heartbeat_;
+        *it++ = static_cast<std::uint8_t>(')');
+        return static_cast<std::size_t>(it - out.begin());
     }
 
-    [[nodiscard]] auto sendFileReadRequest(FileLocationSpecifier& fls) -> bool
+    [[nodiscard]] auto consumeLogBudget(const std::size_t size) -> bool
     {
-        std::array<std::uint8_t, dsdl::File::ReadRequestCapacity> buf{};
+        if (par_.log_bandwidth == 0)
+        {
+            return true;
+        }
+        const auto cost = static_cast<std::uint64_t>(size) * LogBudgetScale;
+        if (cost > log_budget_)
+        {
+            return false;
+        }
+        log_budget_ -= cost;
+        return true;
+    }
 
-        auto of = fls.pending.value().offset;
+    [[nodiscard]] auto sendFileReadRequest(FileLocationSpecifier& fls) -> bool
+    {
+        auto& buf = read_request_;
+        auto  of  = fls.pending.value().offset;
         buf[0]  = static_cast<std::uint8_t>(of);
         of >>= BitsPerByte;
         buf[1] = static_cast<std::uint8_t>(of);
@@ -1013,14 +1457,33 @@ private:
         static constexpr auto length_minus_path = 6U;
         buf.at(length_minus_path - 1U)          = static_cast<std::uint8_t>(fls.path_length);
         (void) std::memmove(&buf.at(length_minus_path), fls.path.data(), fls.path_length);
-        INode* const node = nodes_.at(fls.local_node_index);
+        read_request_size_ = fls.path_length + length_minus_path;
 
         read_transfer_id_++;
-        return node->sendRequest(ServiceID::FileRead,
-                                 fls.server_node_id,
-                                 read_transfer_id_,
-                                 fls.path_length + length_minus_path,
-                                 buf.data());
+        bool result = false;
+        nodes_.visit(fls.local_node_index, [this, &fls, &result](INode& node) {
+            result = node.sendRequest(ServiceID::FileRead,
+                                      fls.server_node_id,
+                                      read_transfer_id_,
+                                      read_request_size_,
+                                      read_request_.data());
+        });
+        return result;
+    }
+
+    /// The request is not serialized again; the node may also reuse its encoding of the previous request.
+    [[nodiscard]] auto resendFileReadRequest(const FileLocationSpecifier& fls) -> bool
+    {
+        read_transfer_id_++;
+        bool result = false;
+        nodes_.visit(fls.local_node_index, [this, &fls, &result](INode& node) {
+            result = node.resendRequest(ServiceID::FileRead,
+                                        fls.server_node_id,
+                                        read_transfer_id_,
+                                        read_request_size_,
+                                        read_request_.data());
+        });
+        return result;
     }
 
     void beginUpdate(const std::uint8_t        local_node_index,
@@ -1036,20 +1499,17 @@ private:
 
         if (file_loc_spec_ && file_loc_spec_->pending)
         {
-            nodes_.at(file_loc_spec_->local_node_index)->cancelRequest();
+            nodes_.visit(file_loc_spec_->local_node_index, [](INode& node) { node.cancelRequest(); });
         }
         file_loc_spec_      = fls;
         current_node_index_ = fls.local_node_index;
         controller_.beginUpdate();
     }
 
-    static constexpr std::uint8_t MaxNodes = 8;
-
-    const Params                 par_;
-    const SystemInfo             system_info_;
-    std::array<INode*, MaxNodes> nodes_{};
-    std::uint8_t                 num_nodes_ = 0;
-    IController&                 controller_;
+    const Params     par_;
+    const SystemInfo system_info_;
+    NodeSet          nodes_;
+    IController&     controller_;
 
     std::chrono::microseconds last_poll_at_{};
 
@@ -1058,14 +1518,106 @@ private:
     std::optional<FileLocationSpecifier> file_loc_spec_;
     TransferID                           read_transfer_id_ = 0;
 
+    /// The last file read request is kept serialized for retransmission.
+    std::array<std::uint8_t, dsdl::File::ReadRequestCapacity> read_request_{};
+    std::size_t                                               read_request_size_ = 0;
+
+    /// The file read response is deposited here by the node and then written into the ROM from here directly.
+    std::array<std::uint8_t, dsdl::File::ReadResponseSizeMax> response_buffer_{};
+
+    std::array<std::uint8_t, dsdl::NodeGetInfo::ResponseSizeMax> node_info_{};
+    std::size_t                                                  node_info_size_ = 0;  ///< Zero if not cached.
+    std::uint32_t                                                node_info_tag_  = 0;  ///< Changes on invalidation.
+
+    bool last_response_cached_ = false;  ///< Whether the last processRequest() was served from node_info_.
+
     TransferID tid_heartbeat_  = 0;
     TransferID tid_log_record_ = 0;
 
+    std::uint64_t log_budget_ = LogBudgetMax;
+
     std::chrono::microseconds next_heartbeat_deadline_{dsdl::Heartbeat::Period};
     dsdl::Heartbeat::Health   node_health_ = dsdl::Heartbeat::Health::Nominal;
     std::uint8_t              node_vssc_   = 0;
 };
 
+using Presenter = BasicPresenter<DynamicNodeSet<8>>;
+
+/// A small bounded queue of diagnostic records awaiting publication.
+/// A record that repeats a queued one (same severity and text) is coalesced into it by incrementing its counter.
+/// If the queue is full, the oldest of the least severe records is evicted unless the new record is less severe.
+/// The text is not copied, so it shall outlive the entry; string literals are the intended use case.
+template <std::size_t Capacity>
+class LogQueue final
+{
+public:
+    struct Entry final
+    {
+        dsdl::Diagnostic::Severity severity{};
+        const char*                text  = nullptr;
+        std::uint32_t              count = 0;
+    };
+
+    void push(const dsdl::Diagnostic::Severity severity, const char* const text)
+    {
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            Entry& e = entries_.at(i);
+            if ((e.severity == severity) && (std::strcmp(e.text, text) == 0))
+            {
+                if (e.count < std::numeric_limits<std::uint32_t>::max())
+                {
+                    e.count++;
+                }
+                return;
+            }
+        }
+        if (size_ >= Capacity)
+        {
+            std::size_t victim = 0;
+            for (std::size_t i = 1; i < size_; i++)
+            {
+                if (entries_.at(i).severity < entries_.at(victim).severity)
+                {
+                    victim = i;
+                }
+            }
+            if (entries_.at(victim).severity > severity)
+            {
+                return;
+            }
+            erase(victim);
+        }
+        entries_.at(size_++) = Entry{severity, text, 1};
+    }
+
+    /// Nullptr if empty.
+    [[nodiscard]] auto front() const -> const Entry* { return (size_ > 0) ? &entries_.front() : nullptr; }
+
+    void pop()
+    {
+        if (size_ > 0)
+        {
+            erase(0);
+        }
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+
+private:
+    void erase(const std::size_t index)
+    {
+        for (std::size_t i = index + 1U; i < size_; i++)
+        {
+            entries_.at(i - 1U) = entries_.at(i);
+        }
+        size_--;
+    }
+
+    std::array<Entry, Capacity> entries_{};
+    std::size_t                 size_ = 0;
+};
+
 }  // namespace detail
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1125,11 +1677,15 @@ enum class Final
 ///
 /// The bootloader may run multiple nodes on different transports concurrently to support multi-transport functionality.
 /// For example, a device may provide the firmware update capability via CAN and a serial port.
-/// The nodes are registered using addNode() after the instance is constructed.
+/// The nodes are kept in the NodeSet: with DynamicNodeSet, they are registered using addNode() after the instance is
+/// constructed; with StaticNodeSet, they are stored in the bootloader by value and constructed together with it.
 ///
 /// If the boot delay is zero and the valid application is found, the bootloader proceeds to start it immediately.
-class Bootloader : public detail::IController
+template <typename NodeSet>
+class BasicBootloader : public detail::IController
 {
+    using Presenter = detail::BasicPresenter<NodeSet>;
+
 public:
     struct Params final
     {
@@ -1163,18 +1719,30 @@ public:
         /// The total maximum number of network service requests is this value plus one.
         /// The counter is reset after every successful request.
         std::uint8_t request_retry_limit = 5;
+
+        /// Diagnostic records are published at most at this rate per node, in bytes of serialized records per second,
+        /// so that a flapping failure cannot flood the bus and starve the file transfer.
+        /// The records in excess are queued, and repeated ones are coalesced. Zero disables the limit.
+        std::uint32_t log_bandwidth = 512;
     };
 
     /// SystemInfo is used for responding to uavcan.node.GetInfo requests.
     /// The lifetime of params is unrestricted as the contents are copied.
-    Bootloader(IROMBackend& rom_backend, const SystemInfo& system_info, const Params& param) :
+    /// The node arguments, if any, are forwarded to the constructor of the node set; e.g., for StaticNodeSet,
+    /// these are the argument tuples of the nodes.
+    template <typename... NodeArgs>
+    BasicBootloader(IROMBackend&      rom_backend,
+                    const SystemInfo& system_info,
+                    const Params&     param,
+                    NodeArgs&&... node_args) :
         max_app_size_(param.max_app_size),
         boot_delay_(param.boot_delay),
         backend_(rom_backend),
         presentation_{
             system_info,
             *this,
-            detail::Presenter::Params{param.request_retry_limit},
+            typename Presenter::Params{param.request_retry_limit, param.log_bandwidth},
+            std::forward<NodeArgs>(node_args)...,
         },
         linger_(param.linger),
         allow_legacy_app_descriptors_(param.allow_legacy_app_descriptors)
@@ -1185,14 +1753,19 @@ public:
     /// Bootloader does NOT manage lifetimes of nodes.
     /// The return value is true on success, false if there are too many nodes already or this node is already
     /// registered (no effect in this case).
+    /// Only available with DynamicNodeSet.
     [[nodiscard]] auto addNode(INode* const node) -> bool { return presentation_.addNode(node); }
 
-    /// The number of nodes added with addNode(). Zero by default (obviously).
+    /// The number of nodes added with addNode() or the size of the static node set.
     [[nodiscard]] auto getNumberOfNodes() const -> std::uint8_t { return presentation_.getNumberOfNodes(); }
 
+    /// Access to the nodes; e.g., to reach the nodes stored by value in StaticNodeSet.
+    [[nodiscard]] auto getNodes() -> NodeSet& { return presentation_.getNodes(); }
+
     /// Non-blocking periodic state update.
     /// The outer logic should invoke this method after any hardware event (for example, if WFE/WFI is used on an
     /// ARM platform), and periodically at least once per second. Typically, it would be invoked from the main loop.
+    /// Instead of polling periodically, the outer logic may sleep until getNextDeadline() or the next hardware event.
     /// The watchdog, if used, should be reset before or after each invocation.
     [[nodiscard]] auto poll(const std::chrono::microseconds time_since_boot) -> std::optional<Final>
     {
@@ -1210,8 +1783,8 @@ public:
             presentation_.setNodeVSSC(static_cast<std::uint8_t>(read_request_count_));  // Indicate progress.
             if (!presentation_.requestFileRead(rom_offset_))
             {
-                presentation_.publishLogRecord(detail::dsdl::Diagnostic::Severity::Critical,
-                                               "Could not send request uavcan.file.Read, abort");
+                log_queue_.push(detail::dsdl::Diagnostic::Severity::Critical,
+                                "Could not send request uavcan.file.Read, abort");
                 reset(false);
             }
         }
@@ -1228,16 +1801,42 @@ public:
             presentation_.poll(uptime_);
         }
 
-        if (pending_log_)
+        // Send logs as late as possible to take into account the new entries from this poll().
+        // The records that do not fit into the bandwidth budget remain queued until the next poll().
+        while (const auto* const entry = log_queue_.front())
         {
-            // Send logs as late as possible to take into account the new entries from this poll().
-            presentation_.publishLogRecord(pending_log_->first, pending_log_->second);
-            pending_log_.reset();
+            if (!presentation_.publishLogRecord(entry->severity, entry->text, entry->count))
+            {
+                break;
+            }
+            log_queue_.pop();
         }
 
         return final_;
     }
 
+    /// The earliest time since boot when poll() needs to be invoked again unless a hardware event occurs earlier,
+    /// such as the heartbeat, a request retry, the end of the boot delay, or a deadline reported by a node.
+    /// The result is valid until the next invocation of poll() or trigger(). It is never later than one heartbeat
+    /// period after the last poll(), and it may be in the past, meaning that poll() should be invoked immediately.
+    [[nodiscard]] auto getNextDeadline() const -> std::chrono::microseconds
+    {
+        if ((!inited_) || final_ || request_read_)
+        {
+            return uptime_;
+        }
+        auto out = presentation_.getNextDeadline();
+        if (State::BootDelay == state_)
+        {
+            out = std::min(out, boot_deadline_);
+        }
+        if (log_queue_.size() > 0)
+        {
+            out = std::min(out, presentation_.getLogBudgetDeadline());
+        }
+        return out;
+    }
+
     /// Manual trigger: commence the application update process without waiting for an external node to trigger it.
     /// This is normally used when the application commands the bootloader to begin the update directly.
     /// Returns false if the node reference is invalid; otherwise true.
@@ -1275,6 +1874,7 @@ private:
             backend_.endWrite();
         }
         app_info_ = detail::AppLocator(backend_, max_app_size_).identifyApplication(allow_legacy_app_descriptors_);
+        presentation_.invalidateNodeInfo();  // The application info is the only variable part of the GetInfo response.
         final_.reset();
         if (app_info_)
         {
@@ -1306,11 +1906,11 @@ private:
         if (State::AppUpdateInProgress == state_)
         {
             backend_.endWrite();  // Cycle the state to re-init ROM if needed.
-            pending_log_ = {detail::dsdl::Diagnostic::Severity::Warning, "Ongoing software update restarted"};
+            log_queue_.push(detail::dsdl::Diagnostic::Severity::Warning, "Ongoing software update restarted");
         }
         else
         {
-            pending_log_ = {detail::dsdl::Diagnostic::Severity::Notice, "Software update started"};
+            log_queue_.push(detail::dsdl::Diagnostic::Severity::Notice, "Software update started");
         }
         state_              = State::AppUpdateInProgress;
         rom_offset_         = 0;
@@ -1324,8 +1924,8 @@ private:
     {
         if (!response)
         {
-            pending_log_ = {detail::dsdl::Diagnostic::Severity::Critical,
-                            "Software image file request timeout or file server error"};
+            log_queue_.push(detail::dsdl::Diagnostic::Severity::Critical,
+                            "Software image file request timeout or file server error");
             reset(false);
         }
         else
@@ -1341,7 +1941,7 @@ private:
             {
                 if (!ok)
                 {
-                    pending_log_ = {detail::dsdl::Diagnostic::Severity::Critical, "ROM write failure"};
+                    log_queue_.push(detail::dsdl::Diagnostic::Severity::Critical, "ROM write failure");
                 }
                 reset(true);
             }
@@ -1351,10 +1951,10 @@ private:
     const std::size_t          max_app_size_;
     const std::chrono::seconds boot_delay_;
 
-    IROMBackend&      backend_;
-    detail::Presenter presentation_;
-    const bool        linger_;
-    const bool        allow_legacy_app_descriptors_;
+    IROMBackend& backend_;
+    Presenter    presentation_;
+    const bool   linger_;
+    const bool   allow_legacy_app_descriptors_;
 
     std::chrono::microseconds uptime_{};
     bool                      inited_ = false;
@@ -1366,9 +1966,15 @@ private:
     bool                      request_read_       = false;
     std::optional<AppInfo>    app_info_;
 
-    std::optional<std::pair<detail::dsdl::Diagnostic::Severity, const char*>> pending_log_;
+    static constexpr std::size_t LogQueueCapacity = 4;
+
+    detail::LogQueue<LogQueueCapacity> log_queue_;
 };
 
+/// The default bootloader that accepts up to 8 nodes registered at runtime.
+/// Use BasicBootloader with a different DynamicNodeSet capacity or with StaticNodeSet for other configurations.
+using Bootloader = BasicBootloader<DynamicNodeSet<8>>;
+
 // --------------------------------------------------------------------------------------------------------------------
 
 /// This helper class allows the bootloader and the application to exchange arbitrary data in a robust way.
@@ -28,6 +28,19 @@ struct CANAcceptanceFilterConfig
     /// the zero-zero configuration as "reject everything" rather than "accept everything".
     [[nodiscard]] static auto makePromiscuous() -> CANAcceptanceFilterConfig { return {AllSet, 0}; }
 
+    /// True if the specified CAN ID is accepted by this filter.
+    [[nodiscard]] auto match(const std::uint32_t can_id) const -> bool
+    {
+        return ((can_id ^ extended_can_id) & mask) == 0U;
+    }
+
+    /// Constructs the most selective single filter that accepts every frame accepted by either of the two filters.
+    [[nodiscard]] auto merge(const CANAcceptanceFilterConfig& other) const -> CANAcceptanceFilterConfig
+    {
+        const std::uint32_t out_mask = mask & other.mask & ~(extended_can_id ^ other.extended_can_id) & AllSet;
+        return {extended_can_id & out_mask, out_mask};
+    }
+
     [[nodiscard]] auto operator==(const CANAcceptanceFilterConfig& cfg) const -> bool
     {
         return (extended_can_id == cfg.extended_can_id) && (mask == cfg.mask);
@@ -79,6 +92,42 @@ public:
                                          const bool                       silent,
                                          const CANAcceptanceFilterConfig& filter) -> std::optional<Mode> = 0;
 
+    /// This is an optional extension for CAN controllers that provide several acceptance filter banks.
+    /// The bootloader will use configureMulti() instead of configure() in the non-silent mode if this method
+    /// returns a value greater than one; otherwise, a single coarse filter will be passed to configure().
+    [[nodiscard]] virtual auto getMaxAcceptanceFilters() const -> std::size_t { return 1; }
+
+    /// This is like configure() except that a frame shall be accepted if it matches ANY of the specified filters.
+    /// The number of filters is never greater than getMaxAcceptanceFilters() and never zero.
+    /// The default implementation merges all filters into one and delegates the call to configure().
+    [[nodiscard]] virtual auto configureMulti(const Bitrate&                         bitrate,
+                                              const bool                             silent,
+                                              const std::size_t                      num_filters,
+                                              const CANAcceptanceFilterConfig* const filters) -> std::optional<Mode>
+    {
+        KOCHERGA_ASSERT((num_filters > 0) && (filters != nullptr));
+        CANAcceptanceFilterConfig acc = filters[0];  // NOLINT NOSONAR pointer arithmetic
+        for (std::size_t i = 1; i < num_filters; i++)
+        {
+            acc = acc.merge(filters[i]);  // NOLINT NOSONAR pointer arithmetic
+        }
+        return configure(bitrate, silent, acc);
+    }
+
+    /// This is an optional extension for CAN FD controllers that cannot handle the full 64-byte frames.
+    /// The returned value should be a valid CAN FD frame payload size not less than 8 bytes; otherwise, it is rounded
+    /// down to the nearest valid size (but not below 8). The bootloader will not emit longer frames.
+    /// This is ignored if the controller operates in the Classic CAN mode.
+    [[nodiscard]] virtual auto getMaxFDPayloadSize() const -> std::size_t { return 64; }
+
+    /// This is an optional extension for CAN controllers that can report protocol errors detected on the bus
+    /// (bit, stuff, form, CRC errors), which is the case for most controllers even in the silent mode.
+    /// If the configured bit rate does not match the bus, every frame on the bus results in an error,
+    /// which allows the bootloader to reject a wrong bit rate within milliseconds instead of waiting for a timeout.
+    /// Returns the number of errors observed since the last configure() call, saturating at the maximum value;
+    /// an empty option indicates that the controller does not support error reporting (this is the default).
+    [[nodiscard]] virtual auto getProtocolErrorCount() -> std::optional<std::uint32_t> { return {}; }
+
     /// Non-blocking addition to the transmission queue of a single CAN frame.
     /// The transmission queue shall be at least 100 Classic CAN frames deep, or at least 10 CAN FD frames deep.
     /// Returns true on success, false if: 1. no space available; 2. a transient error occurred; 3. payload_size > MTU.
@@ -116,6 +165,23 @@ public:
     constexpr static std::array<std::uint8_t, 16> DLCToLength{{0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64}};
 };
 
+/// The parameters of the CAN network discovered by CANNode: the bit rate, the protocol version, and the local node-ID.
+/// The application may persist this object (e.g., in VolatileStorage or in ROM) and pass it to CANNode on the next
+/// start to skip the auto-detection and the PnP node-ID allocation. It is trivially copyable to facilitate that.
+struct CANNetworkProfile
+{
+    ICANDriver::Bitrate bitrate{};
+    std::uint8_t        protocol_version = 0;  ///< 0 for DroneCAN, 1 for Cyphal/CAN.
+    std::uint8_t        local_node_id    = 0;
+
+    [[nodiscard]] auto operator==(const CANNetworkProfile& rhs) const -> bool
+    {
+        return (bitrate == rhs.bitrate) && (protocol_version == rhs.protocol_version) &&
+               (local_node_id == rhs.local_node_id);
+    }
+};
+static_assert(std::is_trivially_copyable_v<CANNetworkProfile>);
+
 /// This is an isolated component intended for use in embedded applications for queueing TX CAN frames.
 /// Systems that leverage higher-level CAN backends (like SocketCAN in Zephyr/NuttX/Linux) will not need this.
 /// Systems that run on bare metal probably will.
@@ -233,8 +299,9 @@ private:
 
 namespace detail
 {
-using kocherga::detail::BitsPerByte;  // NOSONAR
-using kocherga::detail::CRC16CCITT;   // NOSONAR
+using kocherga::detail::BitsPerByte;       // NOSONAR
+using kocherga::detail::CRC16CCITT;        // NOSONAR
+using kocherga::detail::ResponseCRCCache;  // NOSONAR
 
 static constexpr std::uint8_t TailByteStartOfTransfer = 0b1000'0000;
 static constexpr std::uint8_t TailByteEndOfTransfer   = 0b0100'0000;
@@ -242,6 +309,11 @@ static constexpr std::uint8_t TailByteToggleBit       = 0b0010'0000;
 
 static constexpr std::uint8_t MaxTransferID = 31;
 
+/// The number of clients whose requests can be reassembled concurrently. Requests with a large extent use the smaller
+/// limit because each session of theirs costs a few hundred bytes of RAM; requests with small extent are cheap.
+static constexpr std::size_t MaxConcurrentClients      = 4;
+static constexpr std::size_t MaxConcurrentClientsLarge = 2;
+
 inline auto makePseudoUniqueID(const SystemInfo::UniqueID& uid) -> std::uint64_t
 {
     CRC64 crc;
@@ -286,6 +358,165 @@ template <>
     };
 }
 
+/// A small set of acceptance filters that precisely covers the frames consumed by the bootloader.
+/// The set can be reduced to fit into the available hardware filter banks at the cost of admitting extra traffic.
+class AcceptanceFilterSet
+{
+public:
+    static constexpr std::size_t Capacity = 3;
+
+    void add(const CANAcceptanceFilterConfig& filter)
+    {
+        KOCHERGA_ASSERT(size_ < Capacity);
+        union_               = (size_ > 0) ? union_.merge(filter) : filter;
+        filters_.at(size_++) = filter;
+    }
+
+    /// Merges filters pairwise until the size does not exceed the limit.
+    /// At each step, the pair whose merge retains the greatest number of mask bits is chosen, so that the resulting
+    /// set remains as selective as possible. The reduced set is guaranteed to accept every frame the original did.
+    void reduce(const std::size_t max_size)
+    {
+        KOCHERGA_ASSERT(max_size > 0);
+        while (size_ > max_size)
+        {
+            std::size_t best_a = 0;
+            std::size_t best_b = 1;
+            std::size_t best_w = 0;
+            for (std::size_t a = 0; a < size_; a++)
+            {
+                for (std::size_t b = a + 1U; b < size_; b++)
+                {
+                    if (const auto w = countBits(filters_.at(a).merge(filters_.at(b)).mask); w >= best_w)
+                    {
+                        best_a = a;
+                        best_b = b;
+                        best_w = w;
+                    }
+                }
+            }
+            filters_.at(best_a) = filters_.at(best_a).merge(filters_.at(best_b));
+            filters_.at(best_b) = filters_.at(size_ - 1U);
+            size_--;
+        }
+    }
+
+    /// A frame is accepted if it matches any filter in the set.
+    /// This is intended for use as a software filter on the hot path, so it is made cheap for the common case of an
+    /// irrelevant frame: the bits that are common to all filters are checked with a single mask/compare first.
+    [[nodiscard]] auto match(const std::uint32_t can_id) const -> bool
+    {
+        if ((size_ == 0) || !union_.match(can_id))
+        {
+            return false;
+        }
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            if (filters_[i].match(can_id))  // NOLINT NOSONAR the index is always valid
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto size() const -> std::size_t { return size_; }
+    [[nodiscard]] auto data() const -> const CANAcceptanceFilterConfig* { return filters_.data(); }
+
+private:
+    [[nodiscard]] static auto countBits(std::uint32_t x) -> std::size_t
+    {
+        std::size_t out = 0;
+        while (x != 0U)
+        {
+            out += x & 1U;
+            x >>= 1U;
+        }
+        return out;
+    }
+
+    std::array<CANAcceptanceFilterConfig, Capacity> filters_{};
+    std::size_t                                      size_ = 0;
+    CANAcceptanceFilterConfig                        union_{};  ///< Accepts every frame that any filter accepts.
+};
+
+/// Unlike makeAcceptanceFilter(), this function constructs one filter per port consumed by the bootloader.
+/// If the local-ID is provided, the set matches only on the service transfers the bootloader handles.
+/// If the local-ID is not provided, the set matches on PnP allocation response messages only.
+template <std::uint8_t Version>
+[[nodiscard]] auto makeAcceptanceFilterSet(const std::optional<std::uint8_t> local_node_id) -> AcceptanceFilterSet;
+template <>
+[[nodiscard]] inline auto makeAcceptanceFilterSet<0>(const std::optional<std::uint8_t> local_node_id)
+    -> AcceptanceFilterSet
+{
+    AcceptanceFilterSet out;
+    if (local_node_id)
+    {
+        const auto service = [nid = *local_node_id](const std::uint8_t service_id, const bool request) {
+            return CANAcceptanceFilterConfig{
+                0b00000'00000000'0'0000000'1'0000000U | (static_cast<std::uint32_t>(service_id) << 16U) |
+                    (static_cast<std::uint32_t>(request) << 15U) | (static_cast<std::uint32_t>(nid) << 8U),
+                0b00000'11111111'1'1111111'1'0000000U,
+            };
+        };
+        out.add(service(1, true));    // uavcan.protocol.GetNodeInfo
+        out.add(service(40, true));   // uavcan.protocol.file.BeginFirmwareUpdate
+        out.add(service(48, false));  // uavcan.protocol.file.Read
+    }
+    else
+    {
+        out.add(makeAcceptanceFilter<0>({}));  // There is only one port, the coarse filter is already exact.
+    }
+    return out;
+}
+template <>
+[[nodiscard]] inline auto makeAcceptanceFilterSet<1>(const std::optional<std::uint8_t> local_node_id)
+    -> AcceptanceFilterSet
+{
+    AcceptanceFilterSet out;
+    if (local_node_id)
+    {
+        const auto service = [nid = *local_node_id](const ServiceID service_id, const bool request) {
+            return CANAcceptanceFilterConfig{
+                0b000'10'0000000000'0000000'0000000U | (static_cast<std::uint32_t>(request) << 24U) |
+                    (static_cast<std::uint32_t>(service_id) << 14U) | (static_cast<std::uint32_t>(nid) << 7U),
+                0b000'11'1111111111'1111111'0000000U,
+            };
+        };
+        out.add(service(ServiceID::FileRead, false));
+        out.add(service(ServiceID::NodeGetInfo, true));
+        out.add(service(ServiceID::NodeExecuteCommand, true));
+    }
+    else
+    {
+        for (const auto subject_id : {SubjectID::PnPNodeIDAllocationData_v1, SubjectID::PnPNodeIDAllocationData_v2})
+        {
+            out.add({
+                static_cast<std::uint32_t>(subject_id) << 8U,
+                0b000'11'1001111111111111'10000000U,
+            });
+        }
+    }
+    return out;
+}
+
+/// Configures the driver in the non-silent mode to receive only the frames that are relevant for the specified
+/// protocol version and local node-ID. If the driver supports multiple acceptance filters, they are used to admit
+/// only the relevant ports; otherwise, a single coarse filter is used.
+template <std::uint8_t Version>
+[[nodiscard]] auto configureDriver(ICANDriver&                       driver,
+                                   const ICANDriver::Bitrate&        bitrate,
+                                   const std::optional<std::uint8_t> local_node_id) -> std::optional<ICANDriver::Mode>
+{
+    if (const auto max_filters = driver.getMaxAcceptanceFilters(); max_filters > 1U)
+    {
+        auto fs = makeAcceptanceFilterSet<Version>(local_node_id);
+        fs.reduce(max_filters);
+        return driver.configureMulti(bitrate, false, fs.size(), fs.data());
+    }
+    return driver.configure(bitrate, false, makeAcceptanceFilter<Version>(local_node_id));
+}
+
 struct FrameModel
 {
     std::uint8_t priority    = std::numeric_limits<std::uint8_t>::max();
@@ -465,77 +696,150 @@ struct ServiceFrameModel : FrameModel
     return out;
 }
 
+/// A tiny fixed-capacity table of reassembly sessions keyed by the source node-ID.
+/// The port-ID is not part of the key because each reassembler instance serves one port only.
+/// When a new source is encountered and the table is full, the least recently used session is evicted.
+/// The linear search is adequate because the capacity is always very small.
+/// The Session type shall provide a reset() method that returns it into the initial state.
+template <typename Session, std::size_t Capacity>
+class SessionTable
+{
+public:
+    static_assert(Capacity > 0);
+
+    /// Returns nullptr if there is no session for this source. The returned session is marked as recently used.
+    [[nodiscard]] auto find(const std::uint8_t source_node_id) -> Session*
+    {
+        for (auto& e : entries_)
+        {
+            if (e.source_node_id && (*e.source_node_id == source_node_id))
+            {
+                e.last_access = ++access_counter_;
+                return &e.session;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Like find() but creates a new session if there is none, evicting the least recently used one if necessary.
+    [[nodiscard]] auto findOrCreate(const std::uint8_t source_node_id) -> Session&
+    {
+        if (Session* const out = find(source_node_id))
+        {
+            return *out;
+        }
+        Entry* victim = &entries_.front();
+        for (auto& e : entries_)
+        {
+            if (!e.source_node_id)
+            {
+                victim = &e;
+                break;
+            }
+            // The unsigned subtraction yields the correct age even if the access counter has wrapped around.
+            if ((access_counter_ - e.last_access) > (access_counter_ - victim->last_access))
+            {
+                victim = &e;
+            }
+        }
+        victim->source_node_id = source_node_id;
+        victim->last_access    = ++access_counter_;
+        victim->session.reset();
+        return victim->session;
+    }
+
+private:
+    struct Entry
+    {
+        std::optional<std::uint8_t> source_node_id;
+        std::uint32_t               last_access = 0;
+        Session                     session{};
+    };
+    std::array<Entry, Capacity> entries_{};
+    std::uint32_t               access_counter_ = 0;
+};
+
 /// This transfer reassembler is only suitable for very basic applications such as this bootloader, where the edge
 /// cases that are not correctly handled by this implementation can be tolerated. Other applications should not rely
 /// on it; instead, a proper implementation such as that provided in libcanard should be used.
-/// The main limitation is that this reassembler does not support interleaved transfers, which is OK for the bootloader.
+/// Interleaved transfers are supported from up to MaxSessions distinct sources; each session keeps its own
+/// transfer-ID, toggle, CRC, and payload buffer, so the memory footprint grows linearly with the number of sessions.
 /// The user of this class is responsible for checking the port-ID.
-template <std::size_t Extent>
+template <std::size_t Extent, std::size_t MaxSessions = 1>
 class BasicTransferReasm
 {
 public:
     using Result = std::pair<std::size_t, const std::uint8_t*>;
 
+    /// An external buffer (capacity, pointer) where the payload is to be reassembled instead of the internal storage.
+    /// The capacity of the sink replaces the extent. The same sink shall be supplied with every frame of the transfer.
+    using Sink = std::pair<std::size_t, std::uint8_t*>;
+
 protected:
     BasicTransferReasm() = default;
 
     /// The payload pointer in the result remains valid until the next update.
-    [[nodiscard]] auto updateImpl(const FrameModel& frame, const std::uint8_t source) -> std::optional<Result>
+    /// If the sink is not provided, the internal storage is used, whose size is defined by the extent.
+    [[nodiscard]] auto updateImpl(const FrameModel& frame, const std::uint8_t source, const Sink& sink = {})
+        -> std::optional<Result>
     {
+        Session* ses = nullptr;
         if (frame.start_of_transfer)
         {
-            if ((source == source_node_id_) && (frame.transfer_id == transfer_id_))
+            ses = &sessions_.findOrCreate(source);
+            if (frame.transfer_id == ses->transfer_id)
             {
                 return {};  // Drop the duplicate.
             }
-            start(source, frame.transfer_id);
+            ses->state.emplace();
+            ses->transfer_id = frame.transfer_id;
         }
         else
         {
-            const bool match = state_ &&                               //
-                               (source == source_node_id_) &&          //
-                               (frame.transfer_id == transfer_id_) &&  //
-                               (frame.toggle == !state_->toggle);
+            ses              = sessions_.find(source);
+            const bool match = (ses != nullptr) && ses->state &&        //
+                               (frame.transfer_id == ses->transfer_id) &&  //
+                               (frame.toggle == !ses->state->toggle);
             if (!match)
             {
                 return {};
             }
-            state_->toggle = !state_->toggle;
-        }
-        state_->crc.update(frame.payload_size, frame.payload);
-        const auto sz = std::min(frame.payload_size, payload_.size() - state_->stored_payload_size);
-        std::copy_n(frame.payload, sz, payload_.begin() + state_->stored_payload_size);
-        state_->stored_payload_size += sz;
-        state_->received_payload_size += frame.payload_size;
+            ses->state->toggle = !ses->state->toggle;
+        }
+        auto&      st  = *ses->state;
+        const Sink dst = (sink.second != nullptr) ? sink : Sink{ses->payload.size(), ses->payload.data()};
+        KOCHERGA_ASSERT(dst.first >= st.stored_payload_size);
+        st.crc.update(frame.payload_size, frame.payload);
+        const auto sz = std::min(frame.payload_size, dst.first - st.stored_payload_size);
+        std::copy_n(frame.payload, sz, dst.second + st.stored_payload_size);  // NOLINT NOSONAR pointer arithmetic
+        st.stored_payload_size += sz;
+        st.received_payload_size += frame.payload_size;
         if (frame.end_of_transfer)
         {
-            const TransferState fin = *state_;
-            state_.reset();
+            const TransferState fin = st;
+            ses->state.reset();
             if (frame.start_of_transfer)  // This is a single-frame transfer.
             {
-                return Result{fin.stored_payload_size, payload_.data()};
+                return Result{fin.stored_payload_size, dst.second};
             }
             if ((fin.received_payload_size >= CRC16CCITT::Size) && fin.crc.isResidueCorrect())
             {
                 return Result{std::min(fin.stored_payload_size, fin.received_payload_size - CRC16CCITT::Size),
-                              payload_.data()};
+                              dst.second};
             }
         }
         return {};
     }
 
-    std::array<std::uint8_t, Extent> payload_{};  // NOSONAR
-
-private:
-    void start(const std::uint8_t source_node_id, const std::uint8_t transfer_id)
+    /// Anonymous transfers are not tracked but they still need storage. They reuse a session under a reserved key,
+    /// which cannot collide with a real source because the node-ID range is [0, 127].
+    [[nodiscard]] auto getAnonymousPayloadBuffer() -> std::array<std::uint8_t, Extent>&
     {
-        state_.emplace();
-        source_node_id_ = source_node_id;
-        transfer_id_    = transfer_id;
+        return sessions_.findOrCreate(AnonymousSessionKey).payload;
     }
 
-    std::uint8_t source_node_id_ = std::numeric_limits<std::uint8_t>::max();
-    std::uint8_t transfer_id_    = std::numeric_limits<std::uint8_t>::max();
+private:
+    static constexpr std::uint8_t AnonymousSessionKey = std::numeric_limits<std::uint8_t>::max();
 
     struct TransferState
     {
@@ -544,47 +848,65 @@ private:
         CRC16CCITT  crc;
         bool        toggle = true;
     };
-    std::optional<TransferState> state_;
+
+    struct Session
+    {
+        void reset()
+        {
+            transfer_id = std::numeric_limits<std::uint8_t>::max();
+            state.reset();
+        }
+
+        std::uint8_t                     transfer_id = std::numeric_limits<std::uint8_t>::max();
+        std::optional<TransferState>     state;
+        std::array<std::uint8_t, Extent> payload{};
+    };
+
+    SessionTable<Session, MaxSessions> sessions_;
 };
 
 /// The user of this class is responsible for checking the subject-ID on the received frames.
-template <std::size_t Extent>
-class BasicMessageTransferReasm : public BasicTransferReasm<Extent>
+template <std::size_t Extent, std::size_t MaxSessions = 1>
+class BasicMessageTransferReasm : public BasicTransferReasm<Extent, MaxSessions>
 {
+    using Base = BasicTransferReasm<Extent, MaxSessions>;
+
 public:
-    using typename BasicTransferReasm<Extent>::Result;
+    using typename Base::Result;
 
     /// The payload pointer in the result remains valid until the next update.
     [[nodiscard]] auto update(const MessageFrameModel& frame) -> std::optional<Result>
     {
         if (!frame.source_node_id)  // Anonymous frames accepted unconditionally.
         {
-            const auto sz = std::min(frame.payload_size, payload_.size());
-            std::copy_n(frame.payload, sz, payload_.data());
-            return Result{sz, payload_.data()};
+            auto&      buf = Base::getAnonymousPayloadBuffer();
+            const auto sz  = std::min(frame.payload_size, buf.size());
+            std::copy_n(frame.payload, sz, buf.data());
+            return Result{sz, buf.data()};
         }
-        return BasicTransferReasm<Extent>::updateImpl(frame, *frame.source_node_id);
+        return Base::updateImpl(frame, *frame.source_node_id);
     }
-
-private:
-    using BasicTransferReasm<Extent>::payload_;
 };
 
 /// The user of this class is responsible for checking the service-ID and request/response flag on the received frames.
-template <std::size_t Extent>
-class BasicServiceTransferReasm : public BasicTransferReasm<Extent>
+template <std::size_t Extent, std::size_t MaxSessions = 1>
+class BasicServiceTransferReasm : public BasicTransferReasm<Extent, MaxSessions>
 {
+    using Base = BasicTransferReasm<Extent, MaxSessions>;
+
 public:
-    using typename BasicTransferReasm<Extent>::Result;
+    using typename Base::Result;
+    using typename Base::Sink;
 
     explicit BasicServiceTransferReasm(const std::uint8_t local_node_id) : local_node_id_(local_node_id) {}
 
     /// The payload pointer in the result remains valid until the next update.
-    [[nodiscard]] auto update(const ServiceFrameModel& frame) -> std::optional<Result>
+    /// The sink, if provided, is used instead of the internal storage; see the base class for details.
+    [[nodiscard]] auto update(const ServiceFrameModel& frame, const Sink& sink = {}) -> std::optional<Result>
     {
         if (local_node_id_ == frame.destination_node_id)
         {
-            return BasicTransferReasm<Extent>::updateImpl(frame, frame.source_node_id);
+            return Base::updateImpl(frame, frame.source_node_id, sink);
         }
         return {};
     }
@@ -595,95 +917,127 @@ private:
 
 /// This is like the above but for the legacy v0 protocol.
 /// Unlike the v1 implementation, this one does not implement implicit payload truncation as it is not defined for v0.
-template <std::size_t MaxPayloadSize>
+/// The transfer CRC that prepends the payload of multi-frame transfers is removed; only the payload itself is stored.
+template <std::size_t MaxPayloadSize, std::size_t MaxSessions = 1>
 class BasicTransferReasmV0
 {
 public:
     using Result = std::pair<std::size_t, const std::uint8_t*>;
 
+    /// See the v1 reassembler for details. The capacity of the sink replaces MaxPayloadSize.
+    using Sink = std::pair<std::size_t, std::uint8_t*>;
+
 protected:
     explicit BasicTransferReasmV0(const std::uint64_t signature) : signature_(signature) {}
 
     /// The payload pointer in the result remains valid until the next update.
-    [[nodiscard]] auto updateImpl(const FrameModel& frame, const std::uint8_t source) -> std::optional<Result>
+    /// If the sink is not provided, the internal storage is used, whose size is defined by MaxPayloadSize.
+    [[nodiscard]] auto updateImpl(const FrameModel& frame, const std::uint8_t source, const Sink& sink = {})
+        -> std::optional<Result>
     {
+        Session* ses = nullptr;
         if (frame.start_of_transfer)
         {
-            if ((source == source_node_id_) && (frame.transfer_id == transfer_id_))
+            ses = &sessions_.findOrCreate(source);
+            if (frame.transfer_id == ses->transfer_id)
             {
                 return {};  // Drop the duplicate.
             }
-            start(source, frame.transfer_id);
+            ses->state.emplace();
+            ses->transfer_id = frame.transfer_id;
         }
         else
         {
-            if (!(state_ && (source == source_node_id_) && (frame.transfer_id == transfer_id_) &&
-                  (frame.toggle == !state_->toggle)))
+            ses = sessions_.find(source);
+            if (!((ses != nullptr) && ses->state && (frame.transfer_id == ses->transfer_id) &&
+                  (frame.toggle == !ses->state->toggle)))
+            {
+                return {};
+            }
+            ses->state->toggle = !ses->state->toggle;
+        }
+        auto&             st          = *ses->state;
+        const Sink        dst         = (sink.second != nullptr) ? sink : Sink{ses->buffer.size(), ses->buffer.data()};
+        const bool        single      = frame.start_of_transfer && frame.end_of_transfer;
+        const std::size_t data_offset = (frame.start_of_transfer && !single) ? CRC16CCITT::Size : 0U;
+        if (data_offset > 0)  // The CRC is computed on the fly so that the payload can be streamed into the sink.
+        {
+            if (frame.payload_size < data_offset)
             {
+                ses->state.reset();
                 return {};
             }
-            state_->toggle = !state_->toggle;
+            st.expected_crc = static_cast<std::uint16_t>(frame.payload[0] | (frame.payload[1] << 8U));
+            for (auto i = 0U; i < 8U; i++)
+            {
+                st.crc.update(static_cast<std::uint8_t>((signature_ >> (i * 8U)) & 0xFFU));
+            }
         }
-        if (frame.payload_size > (buffer_.size() - state_->payload_size))
+        const std::uint8_t* const data      = frame.payload + data_offset;  // NOLINT NOSONAR pointer arithmetic
+        const std::size_t         data_size = frame.payload_size - data_offset;
+        KOCHERGA_ASSERT(dst.first >= st.payload_size);
+        if (data_size > (dst.first - st.payload_size))
         {
-            state_.reset();  // Too much payload -- DroneCAN does not define payload truncation.
+            ses->state.reset();  // Too much payload -- DroneCAN does not define payload truncation.
             return {};
         }
-        std::copy_n(frame.payload, frame.payload_size, buffer_.begin() + state_->payload_size);
-        state_->payload_size += frame.payload_size;
+        std::copy_n(data, data_size, dst.second + st.payload_size);  // NOLINT NOSONAR pointer arithmetic
+        st.crc.update(data_size, data);
+        st.payload_size += data_size;
         if (frame.end_of_transfer)
         {
-            const TransferState fin = *state_;
-            state_.reset();
-            if (frame.start_of_transfer)  // This is a single-frame transfer.
+            const TransferState fin = st;
+            ses->state.reset();
+            if (single || (fin.crc.get() == fin.expected_crc))
             {
-                return Result{fin.payload_size, buffer_.data()};
-            }
-            if (fin.payload_size >= CRC16CCITT::Size)
-            {
-                CRC16CCITT crc;
-                for (auto i = 0U; i < 8U; i++)
-                {
-                    crc.update(static_cast<std::uint8_t>((signature_ >> (i * 8U)) & 0xFFU));
-                }
-                crc.update(fin.payload_size - CRC16CCITT::Size, buffer_.begin() + CRC16CCITT::Size);
-                if ((buffer_.at(0) == (crc.get() & 0xFFU)) && (buffer_.at(1) == (crc.get() >> 8U)))
-                {
-                    return Result{fin.payload_size - CRC16CCITT::Size, buffer_.begin() + CRC16CCITT::Size};
-                }
+                return Result{fin.payload_size, dst.second};
             }
         }
         return {};
     }
 
-    std::array<std::uint8_t, MaxPayloadSize + CRC16CCITT::Size> buffer_{};  // NOSONAR
+    using Buffer = std::array<std::uint8_t, MaxPayloadSize>;
 
-private:
-    void start(const std::uint8_t source_node_id, const std::uint8_t transfer_id)
+    /// See the v1 reassembler for the rationale.
+    [[nodiscard]] auto getAnonymousPayloadBuffer() -> Buffer&
     {
-        state_.emplace();
-        source_node_id_ = source_node_id;
-        transfer_id_    = transfer_id;
+        return sessions_.findOrCreate(AnonymousSessionKey).buffer;
     }
 
-    std::uint8_t source_node_id_ = std::numeric_limits<std::uint8_t>::max();
-    std::uint8_t transfer_id_    = std::numeric_limits<std::uint8_t>::max();
+private:
+    static constexpr std::uint8_t AnonymousSessionKey = std::numeric_limits<std::uint8_t>::max();
 
     struct TransferState
     {
-        std::size_t payload_size = 0;
-        bool        toggle       = false;
+        std::size_t   payload_size = 0;
+        bool          toggle       = false;
+        CRC16CCITT    crc;
+        std::uint16_t expected_crc = 0;
     };
-    std::optional<TransferState> state_;
+
+    struct Session
+    {
+        void reset()
+        {
+            transfer_id = std::numeric_limits<std::uint8_t>::max();
+            state.reset();
+        }
+
+        std::uint8_t                 transfer_id = std::numeric_limits<std::uint8_t>::max();
+        std::optional<TransferState> state;
+        Buffer                       buffer{};
+    };
+
+    SessionTable<Session, MaxSessions> sessions_;
 
     const std::uint64_t signature_;
 };
 
 /// The user of this class is responsible for checking the subject-ID on the received frames.
-template <std::size_t MaxPayloadSize>
-class BasicMessageTransferReasmV0 : public BasicTransferReasmV0<MaxPayloadSize>
+template <std::size_t MaxPayloadSize, std::size_t MaxSessions = 1>
+class BasicMessageTransferReasmV0 : public BasicTransferReasmV0<MaxPayloadSize, MaxSessions>
 {
-    using Base = BasicTransferReasmV0<MaxPayloadSize>;
+    using Base = BasicTransferReasmV0<MaxPayloadSize, MaxSessions>;
 
 public:
     using typename Base::Result;
@@ -695,36 +1049,36 @@ public:
     {
         if (!frame.source_node_id)  // Anonymous frames accepted unconditionally.
         {
-            const auto sz = std::min(frame.payload_size, buffer_.size());
-            std::copy_n(frame.payload, sz, buffer_.data());
-            return Result{sz, buffer_.data()};
+            auto&      buf = Base::getAnonymousPayloadBuffer();
+            const auto sz  = std::min(frame.payload_size, buf.size());
+            std::copy_n(frame.payload, sz, buf.data());
+            return Result{sz, buf.data()};
         }
         return Base::updateImpl(frame, *frame.source_node_id);
     }
-
-private:
-    using Base::buffer_;
 };
 
 /// The user of this class is responsible for checking the service-ID and request/response flag on the received frames.
-template <std::size_t MaxPayloadSize>
-class BasicServiceTransferReasmV0 : public BasicTransferReasmV0<MaxPayloadSize>
+template <std::size_t MaxPayloadSize, std::size_t MaxSessions = 1>
+class BasicServiceTransferReasmV0 : public BasicTransferReasmV0<MaxPayloadSize, MaxSessions>
 {
-    using Base = BasicTransferReasmV0<MaxPayloadSize>;
+    using Base = BasicTransferReasmV0<MaxPayloadSize, MaxSessions>;
 
 public:
     using typename Base::Result;
+    using typename Base::Sink;
 
     BasicServiceTransferReasmV0(const std::uint64_t signature, const std::uint8_t local_node_id) :
         Base(signature), local_node_id_(local_node_id)
     {}
 
     /// The payload pointer in the result remains valid until the next update.
-    [[nodiscard]] auto update(const ServiceFrameModel& frame) -> std::optional<Result>
+    /// The sink, if provided, is used instead of the internal storage; see the base class for details.
+    [[nodiscard]] auto update(const ServiceFrameModel& frame, const Sink& sink = {}) -> std::optional<Result>
     {
         if (local_node_id_ == frame.destination_node_id)
         {
-            return Base::updateImpl(frame, frame.source_node_id);
+            return Base::updateImpl(frame, frame.source_node_id, sink);
         }
         return {};
     }
@@ -739,12 +1093,14 @@ private:
 /// The callback shall not be an std::function<> or std::bind<> to avoid heap allocation.
 /// The MTU shall be representable as a valid DLC and be no less than 8 bytes.
 /// The caller is responsible for computing the CAN ID (which shall be the same for all frames of this transfer).
+/// If the same payload is sent repeatedly, the caller may supply its CRC (without the padding) to avoid recomputing it.
 template <typename Callback>
-[[nodiscard]] static inline auto transmit(const Callback&           push_frame,
-                                          const std::size_t         transport_layer_mtu,
-                                          const std::uint8_t        transfer_id,
-                                          const std::size_t         payload_length,
-                                          const std::uint8_t* const payload) -> bool
+[[nodiscard]] static inline auto transmit(const Callback&                   push_frame,
+                                          const std::size_t                 transport_layer_mtu,
+                                          const std::uint8_t                transfer_id,
+                                          const std::size_t                 payload_length,
+                                          const std::uint8_t* const         payload,
+                                          const std::optional<CRC16CCITT>& payload_crc = {}) -> bool
 {
     ICANDriver::PayloadBuffer buf{};
     if ((transport_layer_mtu < 8U) || (transport_layer_mtu > buf.size()) || (transfer_id > MaxTransferID) ||
@@ -770,7 +1126,14 @@ template <typename Callback>
 
     // MULTI-FRAME TRANSFER
     CRC16CCITT crc;
-    crc.update(payload_length, payload);
+    if (payload_crc)
+    {
+        crc = *payload_crc;
+    }
+    else
+    {
+        crc.update(payload_length, payload);
+    }
     std::size_t         remaining = payload_length;
     const std::uint8_t* ptr       = payload;
     bool                toggle    = true;
@@ -833,14 +1196,102 @@ template <typename Callback>
     return push_frame(static_cast<std::uint8_t>(size), buf.data());
 }
 
+/// Estimates the time it takes to transmit the specified transfer using transmit() with the specified MTU over CAN FD.
+/// The result is in arbitrary units proportional to time; bit stuffing is neglected. The per-frame overhead is
+/// significant (especially the arbitration phase transmitted at the nominal bit rate), and so is the padding
+/// of the last frame up to the nearest valid DLC, which is also affected by the placement of the transfer CRC.
+[[nodiscard]] inline auto estimateTransferDuration(const ICANDriver::Bitrate& bitrate,
+                                                   const std::size_t          transport_layer_mtu,
+                                                   const std::size_t          payload_length) -> std::uint64_t
+{
+    // The nominal bit rate phases: SOF, base ID, SRR, IDE, extended ID, RRS, FDF, res, BRS;
+    // then CRC delimiter, ACK, EOF, IFS.
+    static constexpr std::uint64_t NominalBitsPerFrame = 36 + 13;
+    // The data phase excluding the data field: ESI, DLC, stuff count; CRC-17 up to 16 bytes of payload, CRC-21 beyond.
+    static constexpr std::uint64_t DataOverheadBitsShort = 9 + 17;
+    static constexpr std::uint64_t DataOverheadBitsLong  = 9 + 21;
+    static constexpr std::size_t   ShortFrameSize        = 16;
+
+    const std::uint64_t nominal = std::max<std::uint64_t>(bitrate.arbitration, 1U);
+    const std::uint64_t data    = (bitrate.data > 0) ? bitrate.data : nominal;
+    const auto          frame   = [nominal, data](const std::size_t frame_size) -> std::uint64_t {
+        const std::size_t   size = ICANDriver::DLCToLength.at(ICANDriver::LengthToDLC.at(frame_size));
+        const std::uint64_t data_bits =
+            ((size > ShortFrameSize) ? DataOverheadBitsLong : DataOverheadBitsShort) + (size * BitsPerByte);
+        return (NominalBitsPerFrame * data) + (data_bits * nominal);  // Time scaled by (nominal * data).
+    };
+    const std::size_t mtu = transport_layer_mtu - 1U;
+    KOCHERGA_ASSERT((mtu >= 7U) && (mtu <= 63U));
+    if (payload_length <= mtu)
+    {
+        return frame(payload_length + 1U);
+    }
+    // This replicates the logic of transmit(); see there.
+    const std::size_t num_full  = (payload_length - 1U) / mtu;
+    const std::size_t remaining = payload_length - (num_full * mtu);
+    std::uint64_t     out       = num_full * frame(transport_layer_mtu);
+    if ((remaining + CRC16CCITT::Size) <= mtu)
+    {
+        out += frame(remaining + CRC16CCITT::Size + 1U);
+    }
+    else
+    {
+        out += frame(transport_layer_mtu) + frame(remaining + CRC16CCITT::Size + 1U - mtu);
+    }
+    return out;
+}
+
+/// Selects the transport layer MTU for transmit() that minimizes the bus occupancy of the specified CAN FD transfer.
+/// Larger frames are not always better: e.g., without the bit rate switching, a 33-byte payload is sent faster as a
+/// 32-byte frame followed by a 5-byte one than as a single 48-byte frame with 14 bytes of padding.
+/// With the bit rate switching, the per-frame overhead usually dominates, so the largest frames are preferred.
+/// The maximum MTU is usually 64 bytes, but it may be lower if the CAN controller cannot handle long frames;
+/// if it is not a valid DLC length, the nearest smaller valid length is used; the result is never less than 8.
+[[nodiscard]] inline auto planTransportLayerMTU(const ICANDriver::Bitrate& bitrate,
+                                                const std::size_t          max_transport_layer_mtu,
+                                                const std::size_t          payload_length) -> std::size_t
+{
+    std::size_t   best_mtu  = 8;
+    std::uint64_t best_cost = std::numeric_limits<std::uint64_t>::max();
+    for (const auto mtu : ICANDriver::DLCToLength)
+    {
+        if ((mtu >= 8U) && (mtu <= max_transport_layer_mtu))
+        {
+            // Non-strict comparison to prefer larger frames to reduce the number of interrupts on a tie.
+            if (const auto cost = estimateTransferDuration(bitrate, mtu, payload_length); cost <= best_cost)
+            {
+                best_mtu  = mtu;
+                best_cost = cost;
+            }
+        }
+    }
+    return best_mtu;
+}
+
+/// The v0 transfer CRC covers the data type signature followed by the payload.
+[[nodiscard]] inline auto computeTransferCRCV0(const std::uint64_t       signature,
+                                               const std::size_t         payload_length,
+                                               const std::uint8_t* const payload) -> CRC16CCITT
+{
+    CRC16CCITT crc;
+    for (auto i = 0U; i < 8U; i++)
+    {
+        crc.update(static_cast<std::uint8_t>((signature >> (i * 8U)) & 0xFFU));
+    }
+    crc.update(payload_length, payload);
+    return crc;
+}
+
 /// This is like transmit() but for the legacy v0 protocol.
 /// It is substantially simpler because v0 does not need padding and the CRC is located in the first frame.
+/// The transfer CRC may be supplied by the caller; see computeTransferCRCV0().
 template <typename Callback>
-[[nodiscard]] static inline auto transmitV0(const Callback&           push_frame,
-                                            const std::uint64_t       signature,
-                                            const std::uint8_t        transfer_id,
-                                            const std::size_t         payload_length,
-                                            const std::uint8_t* const payload) -> bool
+[[nodiscard]] static inline auto transmitV0(const Callback&                   push_frame,
+                                            const std::uint64_t               signature,
+                                            const std::uint8_t                transfer_id,
+                                            const std::size_t                 payload_length,
+                                            const std::uint8_t* const         payload,
+                                            const std::optional<CRC16CCITT>& transfer_crc = {}) -> bool
 {
     static constexpr auto              MTU = 7U;
     std::array<std::uint8_t, MTU + 1U> buf{};
@@ -857,12 +1308,8 @@ template <typename Callback>
         return push_frame(payload_length + 1, buf.data());
     }
     // MULTI-FRAME TRANSFER
-    CRC16CCITT crc;
-    for (auto i = 0U; i < 8U; i++)
-    {
-        crc.update(static_cast<std::uint8_t>((signature >> (i * 8U)) & 0xFFU));
-    }
-    crc.update(payload_length, payload);
+    const CRC16CCITT crc = transfer_crc ? *transfer_crc : computeTransferCRCV0(signature, payload_length, payload);
+
     std::size_t         remaining = payload_length;
     const std::uint8_t* ptr       = payload;
     // First frame
@@ -998,12 +1445,28 @@ public:
         return false;
     }
 
+    // See kocherga::INode
+    [[nodiscard]] virtual auto resendRequest(const ServiceID           service_id,
+                                             const NodeID              server_node_id,
+                                             const TransferID          transfer_id,
+                                             const std::size_t         payload_length,
+                                             const std::uint8_t* const payload) -> bool
+    {
+        return sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
     // See kocherga::INode
     virtual void cancelRequest()
     {
         // Default implementation has nothing to cancel.
     }
 
+    /// Only the main activities know the complete network profile; others return an empty option.
+    [[nodiscard]] virtual auto getNetworkProfile() const -> std::optional<CANNetworkProfile> { return {}; }
+
+    // See kocherga::INode. The main activities are purely event-driven, so there are no deadlines by default.
+    [[nodiscard]] virtual auto getNextDeadline() const -> std::optional<std::chrono::microseconds> { return {}; }
+
     // See kocherga::INode
     [[nodiscard]] virtual auto publishMessage(const SubjectID           subject_id,
                                               const TransferID          transfer_id,
@@ -1037,8 +1500,8 @@ public:
 class V0MainActivity : public IActivity
 {
 public:
-    V0MainActivity(ICANDriver& driver, const std::uint8_t local_node_id) :
-        driver_(driver), local_node_id_(local_node_id)
+    V0MainActivity(ICANDriver& driver, const ICANDriver::Bitrate& bitrate, const std::uint8_t local_node_id) :
+        driver_(driver), bitrate_(bitrate), local_node_id_(local_node_id)
     {
         KOCHERGA_ASSERT((local_node_id_ > 0) && (local_node_id_ <= MaxNodeID));
     }
@@ -1050,7 +1513,13 @@ public:
         while (const auto transport_frame = driver_.pop(buf))
         {
             const auto [can_id, payload_size] = *transport_frame;
-            if (const auto frame = detail::parseFrameV0(can_id, payload_size, buf.data()))
+            // Most of the traffic is usually irrelevant, so it is rejected early based on the CAN ID alone.
+            // The hardware acceptance filter may be unable to do that because it is often coarse or absent.
+            if (!rx_filter_.match(can_id))
+            {
+                rx_rejected_count_++;
+            }
+            else if (const auto frame = detail::parseFrameV0(can_id, payload_size, buf.data()))
             {
                 if (const auto* const s = std::get_if<ServiceFrameModel>(&*frame))
                 {
@@ -1064,12 +1533,39 @@ public:
 
     [[nodiscard]] auto getLocalNodeID() const -> std::uint8_t { return local_node_id_; }
 
+    [[nodiscard]] auto getNetworkProfile() const -> std::optional<CANNetworkProfile> override
+    {
+        return CANNetworkProfile{bitrate_, 0, local_node_id_};
+    }
+
+    /// The number of received frames that were discarded by the early CAN ID classifier without being parsed.
+    [[nodiscard]] auto getRejectedFrameCount() const -> std::uint64_t { return rx_rejected_count_; }
+
 private:
     [[nodiscard]] auto sendRequest(const ServiceID           service_id,
                                    const NodeID              server_node_id,
                                    const TransferID          transfer_id,
                                    const std::size_t         payload_length,
                                    const std::uint8_t* const payload) -> bool override
+    {
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload, false);
+    }
+
+    [[nodiscard]] auto resendRequest(const ServiceID           service_id,
+                                     const NodeID              server_node_id,
+                                     const TransferID          transfer_id,
+                                     const std::size_t         payload_length,
+                                     const std::uint8_t* const payload) -> bool override
+    {
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload, true);
+    }
+
+    [[nodiscard]] auto sendRequestImpl(const ServiceID           service_id,
+                                       const NodeID              server_node_id,
+                                       const TransferID          transfer_id,
+                                       const std::size_t         payload_length,
+                                       const std::uint8_t* const payload,
+                                       const bool                resend) -> bool
     {
         if ((server_node_id > 0) && (server_node_id <= MaxNodeID))
         {
@@ -1079,7 +1575,8 @@ private:
                 return sendFileReadRequest(server_node_id,
                                            static_cast<std::uint8_t>(transfer_id & MaxTransferID),
                                            payload_length,
-                                           payload);
+                                           payload,
+                                           resend);
             }
         }
         return false;  // Don't know how to translate this request v1 --> v0.
@@ -1149,10 +1646,15 @@ private:
             {
                 if (frame.service_id == static_cast<std::uint16_t>(ServiceTypeID::FileRead))
                 {
-                    if (const auto res = rx_res_file_read_.update(frame))
+                    // The v0 response is reassembled in place leaving room for the v1 length field; see below.
+                    const auto [capacity, buffer] = reactor.getResponseBuffer();
+                    KOCHERGA_ASSERT(capacity >= FileReadResponseHeaderSize);
+                    if (const auto res = rx_res_file_read_.update(frame,
+                                                                  {capacity - FileReadResponseDataOffset,
+                                                                   buffer + FileReadResponseDataOffset}))
                     {
                         pending_request_meta_.reset();
-                        processFileReadResponse(reactor, res->first, res->second);
+                        processFileReadResponse(reactor, res->first, buffer);
                     }
                 }
                 else
@@ -1246,32 +1748,32 @@ private:
         }
     }
 
-    static void processFileReadResponse(IReactor&                 reactor,
-                                        const std::size_t         response_size,
-                                        const std::uint8_t* const response_data)
+    /// The v0 response payload is reassembled at offset 2 of the buffer: [error (2 bytes), data (up to 256 bytes)].
+    /// It is converted into the v1 format in place: [error (2 bytes), data length (2 bytes), data].
+    static void processFileReadResponse(IReactor&           reactor,
+                                        const std::size_t   response_size,
+                                        std::uint8_t* const buffer)
     {
         if (response_size >= 2)
         {
-            std::array<std::uint8_t, 270> buf{};
-            buf.back()     = 0xAA;
-            buf.at(0)      = response_data[0];
-            buf.at(1)      = response_data[1];
             const auto len = response_size - 2U;
             if (len <= 256U)
             {
-                buf.at(2) = static_cast<std::uint8_t>(len >> 0U);
-                buf.at(3) = static_cast<std::uint8_t>(len >> 8U);
-                (void) std::memcpy(buf.begin() + 4, response_data + 2U, len);
-                KOCHERGA_ASSERT(buf.back() == 0xAA);
-                reactor.processResponse(len + 4U, buf.data());
+                buffer[0] = buffer[2];  // NOLINT NOSONAR pointer arithmetic
+                buffer[1] = buffer[3];  // NOLINT NOSONAR pointer arithmetic
+                buffer[2] = static_cast<std::uint8_t>(len >> 0U);  // NOLINT NOSONAR pointer arithmetic
+                buffer[3] = static_cast<std::uint8_t>(len >> 8U);  // NOLINT NOSONAR pointer arithmetic
+                reactor.processResponse(len + FileReadResponseHeaderSize, buffer);
             }
         }
     }
 
+    /// When resending, the payload is the same as in the last request, so the cached transfer CRC is reused.
     [[nodiscard]] auto sendFileReadRequest(const NodeID              server_node_id,
                                            const std::uint8_t        transfer_id,
                                            const std::size_t         payload_length,
-                                           const std::uint8_t* const payload) -> bool
+                                           const std::uint8_t* const payload,
+                                           const bool                resend) -> bool
     {
         if (payload_length >= 6U)
         {
@@ -1286,7 +1788,11 @@ private:
             const std::uint32_t            extended_can_id = CANIDMask |
                                                   (static_cast<std::uint32_t>(ServiceTypeID::FileRead) << 16U) |
                                                   (static_cast<std::uint32_t>(server_node_id) << 8U) | local_node_id_;
-            if (send(FileReadSignature, extended_can_id, transfer_id, path_len + 5U, buf.data()))
+            if (!resend || !request_crc_)
+            {
+                request_crc_ = computeTransferCRCV0(FileReadSignature, path_len + 5U, buf.data());
+            }
+            if (send(FileReadSignature, extended_can_id, transfer_id, path_len + 5U, buf.data(), request_crc_))
             {
                 pending_request_meta_ = PendingRequestMetadata{static_cast<std::uint8_t>(server_node_id),
                                                                static_cast<std::uint16_t>(ServiceTypeID::FileRead),
@@ -1339,11 +1845,12 @@ private:
         return send(LogMessageSignature, CANIDMask | local_node_id_, transfer_id, text_len + 5U, buf.data());
     }
 
-    [[nodiscard]] auto send(const std::uint64_t       signature,
-                            const std::uint32_t       extended_can_id,
-                            const TransferID          transfer_id,
-                            const std::size_t         payload_length,
-                            const std::uint8_t* const payload) -> bool
+    [[nodiscard]] auto send(const std::uint64_t               signature,
+                            const std::uint32_t               extended_can_id,
+                            const TransferID                  transfer_id,
+                            const std::size_t                 payload_length,
+                            const std::uint8_t* const         payload,
+                            const std::optional<CRC16CCITT>& transfer_crc = {}) -> bool
     {
         // This lambda is allocated on the stack, so that the closures do not require heap allocation.
         return detail::transmitV0(
@@ -1357,7 +1864,8 @@ private:
             signature,
             static_cast<std::uint8_t>(transfer_id & detail::MaxTransferID),
             payload_length,
-            payload);
+            payload,
+            transfer_crc);
     }
 
     enum class ServiceTypeID : std::uint8_t
@@ -1380,16 +1888,26 @@ private:
     static constexpr std::uint64_t BeginFirmwareUpdateSignature = 0xB7D725DF72724126ULL;
     static constexpr std::uint64_t FileReadSignature            = 0x8DCDCA939F33F678ULL;
 
-    ICANDriver&        driver_;
-    const std::uint8_t local_node_id_;
+    static constexpr std::size_t FileReadResponseHeaderSize = 4;  ///< The error code followed by the data length.
+    static constexpr std::size_t FileReadResponseDataOffset = 2;  ///< The v0 response lacks the data length field.
+
+    ICANDriver&               driver_;
+    const ICANDriver::Bitrate bitrate_;
+    const std::uint8_t        local_node_id_;
 
     std::optional<PendingRequestMetadata> pending_request_meta_;
+    std::optional<CRC16CCITT>             request_crc_;  ///< Of the last request transfer.
 
     std::array<std::uint8_t, 7> last_node_status_{};
 
-    BasicServiceTransferReasmV0<0>   rx_req_get_node_info_{GetNodeInfoSignature, local_node_id_};
-    BasicServiceTransferReasmV0<200> rx_req_begin_fw_upd_{BeginFirmwareUpdateSignature, local_node_id_};
-    BasicServiceTransferReasmV0<300> rx_res_file_read_{FileReadSignature, local_node_id_};
+    // Requests from several clients may be interleaved. Responses are only accepted from the server we are talking to.
+    BasicServiceTransferReasmV0<0, MaxConcurrentClients> rx_req_get_node_info_{GetNodeInfoSignature, local_node_id_};
+    BasicServiceTransferReasmV0<200, MaxConcurrentClientsLarge> rx_req_begin_fw_upd_{BeginFirmwareUpdateSignature,
+                                                                                       local_node_id_};
+    BasicServiceTransferReasmV0<0> rx_res_file_read_{FileReadSignature, local_node_id_};  ///< Uses the reactor buffer.
+
+    const AcceptanceFilterSet rx_filter_         = makeAcceptanceFilterSet<0>(local_node_id_);
+    std::uint64_t             rx_rejected_count_ = 0;
 };
 
 /// The following example shows the CAN exchange dump collected from a real network using the old GUI Tool.
@@ -1454,6 +1972,12 @@ public:
         return deadline_ ? *deadline_ : std::chrono::microseconds{};
     }
 
+    /// Before the first poll() the scheduler is not initialized yet, so the activity is to be polled immediately.
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        return getDeadline();
+    }
+
     [[nodiscard]] auto getStage() const { return stage_; }
 
 private:
@@ -1507,10 +2031,10 @@ private:
         }
         KOCHERGA_ASSERT(node_id <= MaxNodeID);
         // Allocation done, full match.
-        if (const auto bus_mode = driver_.configure(bitrate_, false, makeAcceptanceFilter<0>(node_id)))
+        if (const auto bus_mode = configureDriver<0>(driver_, bitrate_, node_id))
         {
             (void) bus_mode;
-            return allocator_.construct<V0MainActivity>(driver_, node_id);
+            return allocator_.construct<V0MainActivity>(driver_, bitrate_, node_id);
         }
         return nullptr;
     }
@@ -1610,8 +2134,12 @@ private:
 class V1MainActivity : public IActivity
 {
 public:
-    V1MainActivity(ICANDriver& driver, const ICANDriver::Mode bus_mode, const std::uint8_t local_node_id) :
+    V1MainActivity(ICANDriver&                driver,
+                   const ICANDriver::Bitrate& bitrate,
+                   const ICANDriver::Mode     bus_mode,
+                   const std::uint8_t         local_node_id) :
         driver_(driver),
+        bitrate_(bitrate),
         bus_mode_(bus_mode),
         local_node_id_(local_node_id),
         rx_file_read_response_(local_node_id),
@@ -1626,7 +2154,13 @@ public:
         while (const auto transport_frame = driver_.pop(buf))
         {
             const auto [can_id, payload_size] = *transport_frame;
-            if (const auto frame = detail::parseFrame(can_id, payload_size, buf.data()))
+            // Most of the traffic is usually irrelevant, so it is rejected early based on the CAN ID alone.
+            // The hardware acceptance filter may be unable to do that because it is often coarse or absent.
+            if (!rx_filter_.match(can_id))
+            {
+                rx_rejected_count_++;
+            }
+            else if (const auto frame = detail::parseFrame(can_id, payload_size, buf.data()))
             {
                 if (const auto* const s = std::get_if<ServiceFrameModel>(&*frame))
                 {
@@ -1640,12 +2174,45 @@ public:
 
     [[nodiscard]] auto getLocalNodeID() const -> std::uint8_t { return local_node_id_; }
 
+    [[nodiscard]] auto getNetworkProfile() const -> std::optional<CANNetworkProfile> override
+    {
+        return CANNetworkProfile{bitrate_, 1, local_node_id_};
+    }
+
+    /// The number of received frames that were discarded by the early CAN ID classifier without being parsed.
+    [[nodiscard]] auto getRejectedFrameCount() const -> std::uint64_t { return rx_rejected_count_; }
+
 private:
     [[nodiscard]] auto sendRequest(const ServiceID           service_id,
                                    const NodeID              server_node_id,
                                    const TransferID          transfer_id,
                                    const std::size_t         payload_length,
                                    const std::uint8_t* const payload) -> bool override
+    {
+        request_crc_.emplace();
+        request_crc_->update(payload_length, payload);
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
+    /// The payload is the same as in the last request, so its CRC is reused; only the tail bytes differ.
+    [[nodiscard]] auto resendRequest(const ServiceID           service_id,
+                                     const NodeID              server_node_id,
+                                     const TransferID          transfer_id,
+                                     const std::size_t         payload_length,
+                                     const std::uint8_t* const payload) -> bool override
+    {
+        if (!request_crc_)
+        {
+            return sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+        }
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
+    [[nodiscard]] auto sendRequestImpl(const ServiceID           service_id,
+                                       const NodeID              server_node_id,
+                                       const TransferID          transfer_id,
+                                       const std::size_t         payload_length,
+                                       const std::uint8_t* const payload) -> bool
     {
         static constexpr std::uint32_t CANIDMask = 0b110'11'0000000000'0000000'0000000UL;
         if (server_node_id <= MaxNodeID)
@@ -1654,7 +2221,7 @@ private:
                                 (static_cast<std::uint32_t>(service_id) << 14U) |     //
                                 (static_cast<std::uint32_t>(server_node_id) << 7U) |  //
                                 local_node_id_;
-            if (send(can_id, transfer_id, payload_length, payload))
+            if (send(can_id, transfer_id, payload_length, payload, request_crc_))
             {
                 pending_request_meta_ = PendingRequestMetadata{static_cast<std::uint8_t>(server_node_id),
                                                                static_cast<PortID>(service_id),
@@ -1665,12 +2232,13 @@ private:
         return false;
     }
 
-    [[nodiscard]] auto sendResponse(const std::uint8_t        priority,
-                                    const std::uint16_t       service_id,
-                                    const std::uint8_t        client_node_id,
-                                    const std::uint8_t        transfer_id,
-                                    const std::size_t         payload_length,
-                                    const std::uint8_t* const payload) -> bool
+    [[nodiscard]] auto sendResponse(const std::uint8_t               priority,
+                                    const std::uint16_t              service_id,
+                                    const std::uint8_t               client_node_id,
+                                    const std::uint8_t               transfer_id,
+                                    const std::size_t                payload_length,
+                                    const std::uint8_t* const        payload,
+                                    const std::optional<CRC16CCITT>& payload_crc = {}) -> bool
     {
         static constexpr std::uint32_t CANIDMask = 0b000'10'0000000000'0000000'0000000UL;
         //
@@ -1679,7 +2247,7 @@ private:
                             (static_cast<std::uint32_t>(service_id) << 14U) |     //
                             (static_cast<std::uint32_t>(client_node_id) << 7U) |  //
                             local_node_id_;
-        return send(can_id, transfer_id, payload_length, payload);
+        return send(can_id, transfer_id, payload_length, payload, payload_crc);
     }
 
     void cancelRequest() override { pending_request_meta_.reset(); }
@@ -1722,7 +2290,7 @@ private:
             {
                 if (frame.service_id == static_cast<std::uint16_t>(ServiceID::FileRead))
                 {
-                    if (const auto res = rx_file_read_response_.update(frame))
+                    if (const auto res = rx_file_read_response_.update(frame, reactor.getResponseBuffer()))
                     {
                         processServiceResponse(reactor, res->first, res->second);
                     }
@@ -1756,7 +2324,8 @@ private:
                                 frame.source_node_id,
                                 frame.transfer_id,
                                 *response_size,
-                                response_data.data());
+                                response_data.data(),
+                                response_crc_.update(reactor, frame.service_id, *response_size, response_data.data()));
         }
     }
 
@@ -1768,10 +2337,11 @@ private:
         reactor.processResponse(response_size, response_data);
     }
 
-    [[nodiscard]] auto send(const std::uint32_t       extended_can_id,
-                            const TransferID          transfer_id,
-                            const std::size_t         payload_length,
-                            const std::uint8_t* const payload) -> bool
+    [[nodiscard]] auto send(const std::uint32_t               extended_can_id,
+                            const TransferID                  transfer_id,
+                            const std::size_t                 payload_length,
+                            const std::uint8_t* const         payload,
+                            const std::optional<CRC16CCITT>& payload_crc = {}) -> bool
     {
         // This lambda is allocated on the stack, so that the closures do not require heap allocation.
         return detail::transmit(
@@ -1783,10 +2353,13 @@ private:
                                     static_cast<std::uint8_t>(frame_payload_size),
                                     frame_payload);
             },
-            (bus_mode_ == ICANDriver::Mode::Classic) ? 8U : 64U,
+            (bus_mode_ == ICANDriver::Mode::Classic)
+                ? 8U
+                : planTransportLayerMTU(bitrate_, driver_.getMaxFDPayloadSize(), payload_length),
             static_cast<std::uint8_t>(transfer_id & detail::MaxTransferID),
             payload_length,
-            payload);
+            payload,
+            payload_crc);
     }
 
     struct PendingRequestMetadata
@@ -1796,15 +2369,22 @@ private:
         std::uint8_t transfer_id{};
     };
 
-    ICANDriver&            driver_;
-    const ICANDriver::Mode bus_mode_;
-    const std::uint8_t     local_node_id_;
+    ICANDriver&               driver_;
+    const ICANDriver::Bitrate bitrate_;
+    const ICANDriver::Mode    bus_mode_;
+    const std::uint8_t        local_node_id_;
+
+    // Requests from several clients may be interleaved. Responses are only accepted from the server we are talking to.
+    BasicServiceTransferReasm<0>                              rx_file_read_response_;  ///< Uses the reactor buffer.
+    BasicServiceTransferReasm<0, MaxConcurrentClients>        rx_get_info_request_;
+    BasicServiceTransferReasm<300, MaxConcurrentClientsLarge> rx_execute_command_request_;
 
-    BasicServiceTransferReasm<300> rx_file_read_response_;
-    BasicServiceTransferReasm<0>   rx_get_info_request_;
-    BasicServiceTransferReasm<300> rx_execute_command_request_;
+    const AcceptanceFilterSet rx_filter_         = makeAcceptanceFilterSet<1>(local_node_id_);
+    std::uint64_t             rx_rejected_count_ = 0;
 
     std::optional<PendingRequestMetadata> pending_request_meta_;
+    std::optional<CRC16CCITT>             request_crc_;  ///< Of the payload of the last request.
+    ResponseCRCCache<CRC16CCITT>          response_crc_;
 };
 
 class V1NodeIDAllocationActivity : public IActivity
@@ -1847,6 +2427,11 @@ public:
         return nullptr;
     }
 
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        return deadline_;
+    }
+
 private:
     // The upper bound of the randomization interval cannot be less than 1 second, the maximum is not limited by Spec.
     static constexpr std::chrono::microseconds MaxPeriod{3'000'000};
@@ -1994,9 +2579,9 @@ private:
 
     [[nodiscard]] auto constructSuccessor(const std::uint8_t allocated_node_id) -> IActivity*
     {
-        if (const auto bus_mode = driver_.configure(bitrate_, false, makeAcceptanceFilter<1>(allocated_node_id)))
+        if (const auto bus_mode = configureDriver<1>(driver_, bitrate_, allocated_node_id))
         {
-            return allocator_.construct<V1MainActivity>(driver_, *bus_mode, allocated_node_id);
+            return allocator_.construct<V1MainActivity>(driver_, bitrate_, *bus_mode, allocated_node_id);
         }
         return nullptr;
     }
@@ -2063,7 +2648,17 @@ public:
         return nullptr;
     }
 
-private:
+    /// The listening period starts with the first recognized frame; until then, the activity waits for the traffic.
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        if (highest_version_seen_)
+        {
+            return deadline_ + std::chrono::microseconds{1};  // The deadline is detected when exceeded.
+        }
+        return {};
+    }
+
+    /// Returns the protocol version if it can be determined from the frame, otherwise an empty option.
     [[nodiscard]] static auto tryDetectVersionFromFrame(const std::uint32_t can_id, const std::uint8_t tail_byte)
         -> std::optional<std::uint8_t>
     {
@@ -2081,15 +2676,16 @@ private:
         return {};
     }
 
+private:
     [[nodiscard]] auto constructSuccessor(const std::uint8_t detected_protocol_version) -> IActivity*
     {
-        if ((0 == detected_protocol_version) && (driver_.configure(bitrate_, false, makeAcceptanceFilter<0>({}))))
+        if ((0 == detected_protocol_version) && (configureDriver<0>(driver_, bitrate_, {})))
         {
             return allocator_.construct<V0NodeIDAllocationActivity>(allocator_, driver_, local_uid_, bitrate_);
         }
         if (1 == detected_protocol_version)
         {
-            if (const auto bus_mode = driver_.configure(bitrate_, false, makeAcceptanceFilter<1>({})))
+            if (const auto bus_mode = configureDriver<1>(driver_, bitrate_, {}))
             {
                 return allocator_.construct<V1NodeIDAllocationActivity>(allocator_,
                                                                         driver_,
@@ -2115,45 +2711,481 @@ private:
 class BitrateDetectionActivity : public IActivity
 {
 public:
-    BitrateDetectionActivity(IAllocator& allocator, ICANDriver& driver, const SystemInfo::UniqueID& local_uid) :
+    /// If the preferred bit rate is provided (e.g., the last known good one), it is tried first.
+    BitrateDetectionActivity(IAllocator&                               allocator,
+                             ICANDriver&                               driver,
+                             const SystemInfo::UniqueID&               local_uid,
+                             const std::optional<ICANDriver::Bitrate>& preferred_bitrate = {}) :
         allocator_(allocator), driver_(driver), local_uid_(local_uid)
-    {}
+    {
+        if (preferred_bitrate)
+        {
+            candidates_.at(num_candidates_++) = *preferred_bitrate;
+        }
+        for (const auto& br : ICANDriver::StandardBitrates)
+        {
+            if ((!preferred_bitrate) || !(br == *preferred_bitrate))
+            {
+                candidates_.at(num_candidates_++) = br;
+            }
+        }
+        setting_index_ = num_candidates_ - 1U;
+    }
 
 private:
     auto poll(IReactor& reactor, const std::chrono::microseconds uptime) -> IActivity* override
     {
         (void) reactor;
+        last_poll_at_ = uptime;
         ICANDriver::PayloadBuffer buf{};
         if (bus_mode_ && driver_.pop(buf))
         {
-            const auto bitrate = ICANDriver::StandardBitrates.at(setting_index_ % ICANDriver::StandardBitrates.size());
-            return allocator_.construct<VersionDetectionActivity>(allocator_, driver_, local_uid_, bitrate);
+            return allocator_.construct<VersionDetectionActivity>(allocator_, driver_, local_uid_, getBitrate());
         }
-        if ((!bus_mode_) || (uptime > next_try_at_))
+        if ((!bus_mode_) || (uptime > next_try_at_) || isRejectedByErrors())
         {
             setting_index_++;
-            const auto br = ICANDriver::StandardBitrates.at(setting_index_ % ICANDriver::StandardBitrates.size());
-            bus_mode_     = driver_.configure(br, true, CANAcceptanceFilterConfig::makePromiscuous());
-            next_try_at_  = uptime + ListeningPeriod;
+            bus_mode_       = driver_.configure(getBitrate(), true, CANAcceptanceFilterConfig::makePromiscuous());
+            next_try_at_    = uptime + ListeningPeriod;
+            error_feedback_ = bus_mode_ && driver_.getProtocolErrorCount();
         }
         return nullptr;
     }
 
+    /// If the driver could not be configured, the next setting is to be tried immediately.
+    /// A wrong bit rate produces no traffic that could wake up a tickless host, so if the driver reports protocol
+    /// errors, they are re-checked periodically; otherwise, the early rejection would never happen.
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        if (!bus_mode_)
+        {
+            return std::chrono::microseconds::zero();
+        }
+        const auto timeout = next_try_at_ + std::chrono::microseconds{1};  // The deadline is detected when exceeded.
+        return error_feedback_ ? std::min(timeout, last_poll_at_ + ErrorCheckInterval) : timeout;
+    }
+
+    [[nodiscard]] auto getBitrate() const -> ICANDriver::Bitrate
+    {
+        return candidates_.at(setting_index_ % num_candidates_);
+    }
+
+    /// A few errors are tolerated to avoid rejecting the correct bit rate because of sporadic disturbances.
+    [[nodiscard]] auto isRejectedByErrors() -> bool
+    {
+        const auto errors = driver_.getProtocolErrorCount();
+        return errors && (*errors >= ErrorThreshold);
+    }
+
     /// Heartbeats are exchanged at 1 Hz, so about one second should be enough to determine if the bit rate is
-    /// correct.
+    /// correct. If the driver reports protocol errors, a wrong bit rate is usually rejected much earlier.
     static constexpr std::chrono::microseconds ListeningPeriod{1'100'000};
+    static constexpr std::uint32_t             ErrorThreshold = 3;
+    static constexpr std::chrono::microseconds ErrorCheckInterval{10'000};
 
     IAllocator&                allocator_;
     ICANDriver&                driver_;
     const SystemInfo::UniqueID local_uid_;
 
+    std::array<ICANDriver::Bitrate, ICANDriver::StandardBitrates.size() + 1U> candidates_{};
+    std::size_t                                                               num_candidates_ = 0;
+
     std::optional<ICANDriver::Mode> bus_mode_;
-    std::size_t                     setting_index_ = ICANDriver::StandardBitrates.size() - 1U;
+    std::size_t                     setting_index_ = 0;
     std::chrono::microseconds       next_try_at_{};
+    std::chrono::microseconds       last_poll_at_{};
+    bool                            error_feedback_ = false;  ///< The driver reports the protocol error count.
 };
 
+/// Speculatively applies a previously discovered network profile to skip the auto-detection and PnP allocation.
+/// The bus is observed in the silent mode for the whole validation period before the node goes online:
+/// any received frame confirms the bit rate, a start-of-transfer frame of the expected protocol version confirms the
+/// version, and a frame originating from the profile's node-ID means that the node-ID has been taken by another node.
+/// Every frame is checked for the node-ID conflict, so the node goes online only after the period has expired.
+/// If the traffic contradicts the profile, the discovery is resumed from the last step that is still known to be valid.
+/// If the bus stays silent throughout the validation period, the full bit rate detection is performed.
+class WarmStartActivity : public IActivity
+{
+public:
+    /// The driver shall be already configured in the silent mode with the profile's bit rate and promiscuous filter.
+    WarmStartActivity(IAllocator&                 allocator,
+                      ICANDriver&                 driver,
+                      const SystemInfo::UniqueID& local_uid,
+                      const CANNetworkProfile&    profile) :
+        allocator_(allocator), driver_(driver), local_uid_(local_uid), profile_(profile)
+    {
+        KOCHERGA_ASSERT(profile_.protocol_version <= 1);
+    }
+
+    auto poll(IReactor& reactor, const std::chrono::microseconds uptime) -> IActivity* override
+    {
+        (void) reactor;
+        if (!deadline_)
+        {
+            deadline_ = uptime + ValidationPeriod;
+        }
+        ICANDriver::PayloadBuffer buf{};
+        while (const auto frame = driver_.pop(buf))
+        {
+            const auto [can_id, payload_size] = *frame;
+            bitrate_confirmed_                = true;
+            std::optional<std::uint8_t> version;
+            if (payload_size > 0)  // Cyphal frames are guaranteed to contain the tail byte always.
+            {
+                version = VersionDetectionActivity::tryDetectVersionFromFrame(can_id, buf.at(payload_size - 1U));
+            }
+            if (version && (*version > profile_.protocol_version))
+            {
+                return allocator_.construct<VersionDetectionActivity>(allocator_,
+                                                                      driver_,
+                                                                      local_uid_,
+                                                                      profile_.bitrate);
+            }
+            // Frames of a lower version may coexist with the expected one; they cannot be parsed reliably.
+            const bool expected_version = version && (*version == profile_.protocol_version);
+            if ((!version || expected_version) && isNodeIDTaken(can_id, payload_size, buf.data()))
+            {
+                return constructNodeIDAllocationActivity();
+            }
+            version_confirmed_ = version_confirmed_ || expected_version;
+        }
+        if (uptime >= *deadline_)
+        {
+            if (version_confirmed_)
+            {
+                return constructMainActivity();
+            }
+            if (bitrate_confirmed_)
+            {
+                return allocator_.construct<VersionDetectionActivity>(allocator_,
+                                                                      driver_,
+                                                                      local_uid_,
+                                                                      profile_.bitrate);
+            }
+            // The bus may be silent simply because the other nodes are not up yet, so the old bit rate is retried.
+            return allocator_.construct<BitrateDetectionActivity>(allocator_, driver_, local_uid_, profile_.bitrate);
+        }
+        return nullptr;
+    }
+
+    /// The validation period starts at the first poll(), so the activity is to be polled immediately until then.
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        return deadline_ ? *deadline_ : std::chrono::microseconds::zero();
+    }
+
+private:
+    [[nodiscard]] auto isNodeIDTaken(const std::uint32_t       can_id,
+                                     const std::size_t         payload_size,
+                                     const std::uint8_t* const payload) const -> bool
+    {
+        const auto frame = (profile_.protocol_version == 0) ? parseFrameV0(can_id, payload_size, payload)
+                                                            : parseFrame(can_id, payload_size, payload);
+        if (frame)
+        {
+            if (const auto* const mf = std::get_if<MessageFrameModel>(&*frame))
+            {
+                return mf->source_node_id && (*mf->source_node_id == profile_.local_node_id);
+            }
+            if (const auto* const sf = std::get_if<ServiceFrameModel>(&*frame))
+            {
+                return sf->source_node_id == profile_.local_node_id;
+            }
+        }
+        return false;
+    }
+
+    [[nodiscard]] auto constructMainActivity() -> IActivity*
+    {
+        const auto nid = profile_.local_node_id;
+        if ((profile_.protocol_version == 0) && (nid > 0) && (nid <= MaxNodeID))
+        {
+            if (configureDriver<0>(driver_, profile_.bitrate, nid))
+            {
+                return allocator_.construct<V0MainActivity>(driver_, profile_.bitrate, nid);
+            }
+        }
+        if ((profile_.protocol_version == 1) && (nid <= MaxNodeID))
+        {
+            if (const auto bus_mode = configureDriver<1>(driver_, profile_.bitrate, nid))
+            {
+                return allocator_.construct<V1MainActivity>(driver_, profile_.bitrate, *bus_mode, nid);
+            }
+        }
+        return constructNodeIDAllocationActivity();
+    }
+
+    [[nodiscard]] auto constructNodeIDAllocationActivity() -> IActivity*
+    {
+        if ((profile_.protocol_version == 0) && configureDriver<0>(driver_, profile_.bitrate, {}))
+        {
+            return allocator_.construct<V0NodeIDAllocationActivity>(allocator_, driver_, local_uid_, profile_.bitrate);
+        }
+        if (profile_.protocol_version == 1)
+        {
+            if (const auto bus_mode = configureDriver<1>(driver_, profile_.bitrate, {}))
+            {
+                return allocator_.construct<V1NodeIDAllocationActivity>(allocator_,
+                                                                        driver_,
+                                                                        local_uid_,
+                                                                        profile_.bitrate,
+                                                                        *bus_mode);
+            }
+        }
+        return allocator_.construct<BitrateDetectionActivity>(allocator_, driver_, local_uid_);
+    }
+
+    /// Heartbeats are exchanged at 1 Hz, so every active node, including a conflicting one, is heard within a second.
+    static constexpr std::chrono::microseconds ValidationPeriod{1'100'000};
+
+    IAllocator&                              allocator_;
+    ICANDriver&                              driver_;
+    const SystemInfo::UniqueID               local_uid_;
+    const CANNetworkProfile                  profile_;
+    std::optional<std::chrono::microseconds> deadline_;
+    bool                                     bitrate_confirmed_ = false;
+    bool                                     version_confirmed_ = false;
+};
+
+/// The activity allocator block shall accommodate the largest activity.
+static constexpr std::size_t MaxActivitySize = std::max({sizeof(V0MainActivity),
+                                                         sizeof(V0NodeIDAllocationActivity),
+                                                         sizeof(V1MainActivity),
+                                                         sizeof(V1NodeIDAllocationActivity),
+                                                         sizeof(VersionDetectionActivity),
+                                                         sizeof(BitrateDetectionActivity),
+                                                         sizeof(WarmStartActivity)});
+
 }  // namespace detail
 
+/// An adapter that combines several CAN drivers connected to redundant buses into one.
+/// Pass it to CANNode instead of a single driver to obtain a node that operates on all buses at once,
+/// so that the node-ID allocation, heartbeats, and file transfers are done only once rather than per bus.
+/// Each outgoing frame is sent to every bus; if a bus is congested or faulted, the frame is simply lost there.
+/// Incoming transfers are accepted from whichever bus delivered their first frame earlier; the copies arriving
+/// from the other buses are discarded. This is done per CAN ID using the transfer-ID and the start-of-transfer flag,
+/// which are located in the tail byte identically in Cyphal/CAN and DroneCAN (the transfer-ID is 5-bit in both).
+/// Another bus takes over only if it delivers a transfer whose transfer-ID is ahead of the last accepted one,
+/// so that a lagging bus cannot inject stale duplicates, or if the current bus appears to have been lost.
+/// All drivers shall be connected to the buses operating at the same bit rate.
+/// Usage:
+///     kocherga::can::RedundantCANDriver can_driver(can_driver_a, can_driver_b);
+///     kocherga::can::CANNode can_node(can_driver, system_info.unique_id);
+template <std::size_t NumInterfaces>
+class RedundantCANDriver : public ICANDriver
+{
+public:
+    /// The number of distinct CAN IDs whose transfers are tracked concurrently. If exceeded, the oldest is evicted,
+    /// which may cause a single duplicate to be let through. The bootloader talks to very few nodes at once.
+    static constexpr std::size_t MaxSessions = 16;
+
+    /// The bus that a session is bound to is considered lost if the other buses deliver this many new transfers
+    /// that are not ahead of the last accepted one while the bound bus stays silent. This is needed to recover
+    /// if the remote node is restarted (resetting its transfer-ID counter) while its bus is down.
+    static constexpr std::uint8_t SessionTimeout = 8;
+
+    template <typename... Drivers>
+    explicit RedundantCANDriver(Drivers&... drivers) : drivers_{{&drivers...}}
+    {
+        static_assert(NumInterfaces > 0);
+        static_assert(sizeof...(Drivers) == NumInterfaces);
+    }
+
+    [[nodiscard]] auto configure(const Bitrate& bitrate, const bool silent, const CANAcceptanceFilterConfig& filter)
+        -> std::optional<Mode> override
+    {
+        return configureEach(
+            [&bitrate, silent, &filter](ICANDriver& drv) { return drv.configure(bitrate, silent, filter); });
+    }
+
+    [[nodiscard]] auto getMaxAcceptanceFilters() const -> std::size_t override
+    {
+        std::size_t out = drivers_.front()->getMaxAcceptanceFilters();
+        for (const ICANDriver* const drv : drivers_)
+        {
+            out = std::min(out, drv->getMaxAcceptanceFilters());
+        }
+        return out;
+    }
+
+    [[nodiscard]] auto configureMulti(const Bitrate&                         bitrate,
+                                      const bool                             silent,
+                                      const std::size_t                      num_filters,
+                                      const CANAcceptanceFilterConfig* const filters) -> std::optional<Mode> override
+    {
+        return configureEach([&bitrate, silent, num_filters, filters](ICANDriver& drv) {
+            return drv.configureMulti(bitrate, silent, num_filters, filters);
+        });
+    }
+
+    [[nodiscard]] auto getMaxFDPayloadSize() const -> std::size_t override
+    {
+        std::size_t out = drivers_.front()->getMaxFDPayloadSize();
+        for (const ICANDriver* const drv : drivers_)
+        {
+            out = std::min(out, drv->getMaxFDPayloadSize());
+        }
+        return out;
+    }
+
+    /// Errors are reported only if all drivers support that. The smallest count is reported because a wrong bit rate
+    /// causes errors on every bus, whereas a single faulty bus should not affect the bit rate detection.
+    [[nodiscard]] auto getProtocolErrorCount() -> std::optional<std::uint32_t> override
+    {
+        std::optional<std::uint32_t> out;
+        for (std::size_t i = 0; i < NumInterfaces; i++)
+        {
+            const auto errors = drivers_.at(i)->getProtocolErrorCount();
+            if (!errors)
+            {
+                return {};
+            }
+            if (enabled_.at(i))
+            {
+                out = out ? std::min(*out, *errors) : *errors;
+            }
+        }
+        return out;
+    }
+
+    /// The frame is considered sent if at least one of the buses accepted it.
+    [[nodiscard]] auto push(const bool          force_classic_can,
+                            const std::uint32_t extended_can_id,
+                            const std::uint8_t  payload_size,
+                            const void* const   payload) -> bool override
+    {
+        bool out = false;
+        for (std::size_t i = 0; i < NumInterfaces; i++)
+        {
+            if (enabled_.at(i))
+            {
+                out = drivers_.at(i)->push(force_classic_can, extended_can_id, payload_size, payload) || out;
+            }
+        }
+        return out;
+    }
+
+    /// The interfaces are polled in a round-robin manner so that a flooded bus does not starve the others.
+    [[nodiscard]] auto pop(PayloadBuffer& payload_buffer)
+        -> std::optional<std::pair<std::uint32_t, std::uint8_t>> override
+    {
+        std::size_t idle = 0;
+        while (idle < NumInterfaces)
+        {
+            const std::size_t iface = next_iface_;
+            next_iface_             = (next_iface_ + 1U) % NumInterfaces;
+            const auto frame = enabled_.at(iface) ? drivers_.at(iface)->pop(payload_buffer) : std::nullopt;
+            if (!frame)
+            {
+                idle++;
+            }
+            else
+            {
+                idle = 0;
+                if (accept(iface, frame->first, frame->second, payload_buffer))
+                {
+                    return frame;
+                }
+            }
+        }
+        return {};
+    }
+
+private:
+    struct Session
+    {
+        std::uint32_t can_id{};
+        std::size_t   iface{};
+        std::uint8_t  transfer_id{};
+        std::uint32_t last_access{};
+        std::uint8_t  rejected{};  ///< New transfers from the other buses rejected since the bound bus was heard.
+    };
+
+    template <typename F>
+    [[nodiscard]] auto configureEach(const F& fun) -> std::optional<Mode>
+    {
+        sessions_.fill({});
+        std::optional<Mode> out;
+        for (std::size_t i = 0; i < NumInterfaces; i++)
+        {
+            // A faulted bus is simply excluded; the node keeps operating as long as at least one bus is usable.
+            const auto mode = fun(*drivers_.at(i));
+            enabled_.at(i)  = mode.has_value();
+            if (mode)
+            {
+                // If any of the controllers is Classic-only, the other buses have to use Classic CAN as well.
+                out = (out && (*out == Mode::Classic)) ? Mode::Classic : *mode;
+            }
+        }
+        return out;
+    }
+
+    [[nodiscard]] auto accept(const std::size_t    iface,
+                              const std::uint32_t  can_id,
+                              const std::uint8_t   payload_size,
+                              const PayloadBuffer& payload_buffer) -> bool
+    {
+        if (payload_size == 0)  // Not a valid transfer frame, let the upper layers reject it.
+        {
+            return true;
+        }
+        const std::uint8_t tail        = payload_buffer.at(payload_size - 1U);
+        const bool         sot         = (tail & detail::TailByteStartOfTransfer) != 0;
+        const auto         transfer_id = static_cast<std::uint8_t>(tail & detail::MaxTransferID);
+        access_counter_ = std::max<std::uint32_t>(access_counter_ + 1U, 1U);  // Zero is reserved for unused entries.
+        Session* oldest = &sessions_.front();
+        for (auto& ses : sessions_)
+        {
+            if ((ses.last_access != 0) && (ses.can_id == can_id))
+            {
+                ses.last_access = access_counter_;
+                if (ses.iface == iface)
+                {
+                    ses.transfer_id = sot ? transfer_id : ses.transfer_id;
+                    ses.rejected    = 0;
+                    return true;
+                }
+                if (sot)
+                {
+                    // The transfer-ID is ahead if it is within the first half of the modular range after the last one.
+                    constexpr auto Mod      = detail::MaxTransferID + 1U;
+                    const auto     distance = static_cast<std::uint8_t>((transfer_id + Mod - ses.transfer_id) % Mod);
+                    ses.rejected++;
+                    if (((distance > 0) && (distance < (Mod / 2U))) || (ses.rejected >= SessionTimeout))
+                    {
+                        ses.iface       = iface;  // A new transfer arrived over this bus first.
+                        ses.transfer_id = transfer_id;
+                        ses.rejected    = 0;
+                        return true;
+                    }
+                }
+                return false;  // This is a duplicate of a transfer that is received over another bus.
+            }
+            // Zero access time means that the entry is unused; it is always the oldest.
+            if ((ses.last_access == 0) ||
+                ((oldest->last_access != 0) &&
+                 ((access_counter_ - ses.last_access) > (access_counter_ - oldest->last_access))))
+            {
+                oldest = &ses;
+            }
+        }
+        if (sot)
+        {
+            *oldest = {can_id, iface, transfer_id, access_counter_, 0};
+        }
+        return true;
+    }
+
+    std::array<ICANDriver*, NumInterfaces> drivers_;
+    std::array<bool, NumInterfaces>        enabled_{};
+    std::size_t                            next_iface_ = 0;
+    std::array<Session, MaxSessions>       sessions_{};
+    std::uint32_t                          access_counter_ = 0;
+};
+
+template <typename... Drivers>
+RedundantCANDriver(Drivers&...) -> RedundantCANDriver<sizeof...(Drivers)>;
+
 /// Kocherga node implementing the Cyphal/CAN transport along with DroneCAN with automatic version detection.
 class CANNode : public kocherga::INode
 {
@@ -2174,13 +3206,12 @@ public:
             local_node_id && (*local_node_id > 0) && (*local_node_id <= MaxNodeID))
         {
             if (const auto bus_mode =
-                    driver.configure(*can_bitrate,
-                                     false,
-                                     detail::makeAcceptanceFilter<0>(static_cast<std::uint8_t>(*local_node_id))))
+                    detail::configureDriver<0>(driver, *can_bitrate, static_cast<std::uint8_t>(*local_node_id)))
             {
                 (void) bus_mode;  // v0 doesn't care about mode because it only supports Classic CAN.
                 activity_ =
                     activity_allocator_.construct<detail::V0MainActivity>(driver,
+                                                                          *can_bitrate,
                                                                           static_cast<std::uint8_t>(*local_node_id));
             }
         }
@@ -2189,19 +3220,18 @@ public:
             local_node_id && (*local_node_id <= MaxNodeID))
         {
             if (const auto bus_mode =
-                    driver.configure(*can_bitrate,
-                                     false,
-                                     detail::makeAcceptanceFilter<1>(static_cast<std::uint8_t>(*local_node_id))))
+                    detail::configureDriver<1>(driver, *can_bitrate, static_cast<std::uint8_t>(*local_node_id)))
             {
                 activity_ =
                     activity_allocator_.construct<detail::V1MainActivity>(driver,
+                                                                          *can_bitrate,
                                                                           *bus_mode,
                                                                           static_cast<std::uint8_t>(*local_node_id));
             }
         }
         if ((activity_ == nullptr) && can_bitrate && protocol_version && (*protocol_version == 0))
         {
-            if (const auto bus_mode = driver.configure(*can_bitrate, false, detail::makeAcceptanceFilter<0>({})))
+            if (const auto bus_mode = detail::configureDriver<0>(driver, *can_bitrate, {}))
             {
                 (void) bus_mode;  // v0 doesn't care about mode because it only supports Classic CAN.
                 activity_ = activity_allocator_.construct<detail::V0NodeIDAllocationActivity>(activity_allocator_,
@@ -2212,7 +3242,7 @@ public:
         }
         if ((activity_ == nullptr) && can_bitrate && protocol_version && (*protocol_version == 1))
         {
-            if (const auto bus_mode = driver.configure(*can_bitrate, false, detail::makeAcceptanceFilter<1>({})))
+            if (const auto bus_mode = detail::configureDriver<1>(driver, *can_bitrate, {}))
             {
                 activity_ = activity_allocator_.construct<detail::V1NodeIDAllocationActivity>(activity_allocator_,
                                                                                               driver,
@@ -2242,6 +3272,36 @@ public:
         KOCHERGA_ASSERT(activity_ != nullptr);
     }
 
+    /// This overload re-applies a network profile that was obtained from getNetworkProfile() earlier.
+    /// The profile is validated against the bus traffic before use; if it turns out to be stale,
+    /// the node falls back to the auto-detection and PnP node-ID allocation automatically.
+    CANNode(ICANDriver& driver, const SystemInfo::UniqueID& local_unique_id, const CANNetworkProfile& warm_start)
+    {
+        if ((warm_start.protocol_version <= 1) &&
+            driver.configure(warm_start.bitrate, true, CANAcceptanceFilterConfig::makePromiscuous()))
+        {
+            activity_ = activity_allocator_.construct<detail::WarmStartActivity>(activity_allocator_,
+                                                                                 driver,
+                                                                                 local_unique_id,
+                                                                                 warm_start);
+        }
+        else
+        {
+            activity_ = activity_allocator_.construct<detail::BitrateDetectionActivity>(activity_allocator_,
+                                                                                        driver,
+                                                                                        local_unique_id);
+        }
+        KOCHERGA_ASSERT(activity_ != nullptr);
+    }
+
+    /// The network profile becomes available once the node is fully configured and online.
+    /// Until then, while the auto-detection or PnP allocation are in progress, this method returns an empty option.
+    [[nodiscard]] auto getNetworkProfile() const -> std::optional<CANNetworkProfile>
+    {
+        KOCHERGA_ASSERT(activity_ != nullptr);
+        return activity_->getNetworkProfile();
+    }
+
 private:
     void poll(IReactor& reactor, const std::chrono::microseconds uptime) override
     {
@@ -2264,8 +3324,24 @@ private:
         return activity_->sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
     }
 
+    [[nodiscard]] auto resendRequest(const ServiceID           service_id,
+                                     const NodeID              server_node_id,
+                                     const TransferID          transfer_id,
+                                     const std::size_t         payload_length,
+                                     const std::uint8_t* const payload) -> bool override
+    {
+        KOCHERGA_ASSERT(activity_ != nullptr);
+        return activity_->resendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
     void cancelRequest() override { activity_->cancelRequest(); }
 
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        KOCHERGA_ASSERT(activity_ != nullptr);
+        return activity_->getNextDeadline();
+    }
+
     [[nodiscard]] auto publishMessage(const SubjectID           subject_id,
                                       const TransferID          transfer_id,
                                       const std::size_t         payload_length,
@@ -2275,8 +3351,8 @@ private:
         return activity_->publishMessage(subject_id, transfer_id, payload_length, payload);
     }
 
-    detail::BlockAllocator<1024, 2> activity_allocator_;
-    detail::IActivity*              activity_ = nullptr;
+    detail::BlockAllocator<detail::MaxActivitySize, 2> activity_allocator_;
+    detail::IActivity*                                  activity_ = nullptr;
 };
 
 }  // namespace kocherga::can
@@ -0,0 +1,795 @@
+// This software is distributed under the terms of the MIT License.
+// Copyright (c) 2021 Zubax Robotics.
+// Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+
+#pragma once
+
+#include "kocherga_can.hpp"
+#include "kocherga_serial.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <termios.h>
+#include <unistd.h>
+
+/// Components for running the bootloader as a regular process on a Linux host, such as a companion computer.
+/// Like the rest of the library, this module does not throw; failures are reported POSIX-style via errno.
+namespace kocherga::os_linux
+{
+/// A file descriptor that is serviced by EpollRunner.
+/// The I/O is buffered, so the runner needs to know when the buffers require attention besides fd readiness.
+class IEventSource
+{
+public:
+    [[nodiscard]] virtual auto getFileDescriptor() const -> int = 0;
+
+    /// True if some input has already been read from the file descriptor but not yet consumed by the bootloader.
+    /// The runner does not block while this is the case because the file descriptor may no longer be readable.
+    [[nodiscard]] virtual auto hasBufferedInput() const -> bool = 0;
+
+    /// Write out the buffered output, if any. The runner invokes this after every poll of the bootloader.
+    /// Returns true if some output is still pending; the runner will then wait until the fd is writable.
+    [[nodiscard]] virtual auto flush() -> bool = 0;
+
+    /// The time when flush() is to be invoked again although the fd does not report it; e.g., if the kernel has
+    /// discarded the data for a transient lack of buffer space while the fd stays writable, waiting for EPOLLOUT
+    /// would spin. The runner wakes up by this time at the latest. Empty if no timed retry is needed (default).
+    [[nodiscard]] virtual auto getRetryTime() const -> std::optional<std::chrono::steady_clock::time_point>
+    {
+        return {};
+    }
+
+    virtual ~IEventSource()                              = default;
+    IEventSource()                                       = default;
+    IEventSource(const IEventSource&)                    = delete;
+    IEventSource(IEventSource&&)                         = delete;
+    auto operator=(const IEventSource&) -> IEventSource& = delete;
+    auto operator=(IEventSource&&) -> IEventSource&      = delete;
+};
+
+/// Connects a non-blocking TCP socket to the specified endpoint; the connection is established synchronously.
+/// Returns the file descriptor or -1 on failure, with errno set (h_errno if the host could not be resolved).
+[[nodiscard]] inline auto connectTCP(const char* const remote_host, const std::uint16_t remote_port) -> int
+{
+    const ::hostent* const he = ::gethostbyname(remote_host);
+    if (he == nullptr)
+    {
+        return -1;
+    }
+    ::sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_port   = ::htons(remote_port);
+    sa.sin_addr   = *static_cast<const in_addr*>(static_cast<const void*>(he->h_addr));  // NOLINT union
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    const int one = 1;  // The frames are flushed in whole blocks, so there is nothing for Nagle to coalesce.
+    if ((0 != ::connect(fd, reinterpret_cast<::sockaddr*>(&sa), sizeof(sa))) ||
+        (0 != ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one))) ||
+        (0 != ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK)))  // NOLINT vararg
+    {
+        const int err = errno;
+        (void) ::close(fd);
+        errno = err;
+        return -1;
+    }
+    return fd;
+}
+
+/// Opens a tty device (a UART, a USB CDC ACM port, a pty, etc.) in the non-blocking raw mode: 8N1, no flow control,
+/// no line discipline processing; the stale input is discarded. The device is opened for exclusive use.
+/// The baud rate shall be one of the standard values; USB CDC ACM and pty devices ignore it.
+/// Returns the file descriptor or -1 on failure, with errno set. Pass the result to StreamSerialPort.
+[[nodiscard]] inline auto openTTY(const char* const path, const std::uint32_t baudrate) -> int
+{
+    static constexpr std::array<std::pair<std::uint32_t, ::speed_t>, 21> Speeds{{
+        {1'200, B1200},         {2'400, B2400},         {4'800, B4800},         {9'600, B9600},
+        {19'200, B19200},       {38'400, B38400},       {57'600, B57600},       {115'200, B115200},
+        {230'400, B230400},     {460'800, B460800},     {500'000, B500000},     {576'000, B576000},
+        {921'600, B921600},     {1'000'000, B1000000},  {1'152'000, B1152000},  {1'500'000, B1500000},
+        {2'000'000, B2000000},  {2'500'000, B2500000},  {3'000'000, B3000000},  {3'500'000, B3500000},
+        {4'000'000, B4000000},
+    }};
+    const auto* const speed =
+        std::find_if(Speeds.begin(), Speeds.end(), [baudrate](const auto& x) { return x.first == baudrate; });
+    if (speed == Speeds.end())
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    const int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);  // NOLINT vararg signed bitwise
+    if (fd < 0)
+    {
+        return -1;
+    }
+    const auto fail = [fd]() {
+        const int err = errno;
+        (void) ::close(fd);
+        errno = err;
+        return -1;
+    };
+    ::termios tio{};
+    if ((0 != ::ioctl(fd, TIOCEXCL)) || (0 != ::tcgetattr(fd, &tio)))  // NOLINT vararg
+    {
+        return fail();
+    }
+    ::cfmakeraw(&tio);
+    tio.c_cflag |= static_cast<::tcflag_t>(CLOCAL | CREAD);
+    tio.c_cflag &= static_cast<::tcflag_t>(~static_cast<::tcflag_t>(CSTOPB | CRTSCTS));
+    tio.c_cc[VMIN]  = 0;  // NOLINT array index
+    tio.c_cc[VTIME] = 0;  // NOLINT array index
+    if ((0 != ::cfsetispeed(&tio, speed->second)) || (0 != ::cfsetospeed(&tio, speed->second)) ||
+        (0 != ::tcsetattr(fd, TCSANOW, &tio)) || (0 != ::tcflush(fd, TCIOFLUSH)))
+    {
+        return fail();
+    }
+    return fd;
+}
+
+/// ISerialPort over a stream file descriptor: a TCP socket, a pipe, a tty, etc.
+/// The data is read and written in large blocks through the internal buffers, so the number of syscalls is
+/// proportional to the number of blocks rather than bytes. The output is written out on flush() or when the TX
+/// buffer is full. The file descriptor is switched into the non-blocking mode and is closed on destruction.
+class StreamSerialPort final : public serial::ISerialPort, public IEventSource
+{
+public:
+    /// The size of each of the RX and TX buffers in bytes.
+    static constexpr std::size_t BufferSize = 16 * 1024;
+
+    struct Statistics final
+    {
+        std::uint64_t bytes_received = 0;
+        std::uint64_t bytes_sent     = 0;
+        std::uint64_t syscalls       = 0;  ///< The number of read() and write() (or send()) invocations.
+    };
+
+    explicit StreamSerialPort(const int fd) : fd_(fd)
+    {
+        struct ::stat st{};
+        is_socket_ = (0 == ::fstat(fd_, &st)) && S_ISSOCK(st.st_mode);     // NOLINT signed bitwise
+        (void) ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) | O_NONBLOCK);  // NOLINT vararg
+    }
+
+    ~StreamSerialPort() override { (void) ::close(fd_); }
+
+    StreamSerialPort(const StreamSerialPort&)                    = delete;
+    StreamSerialPort(StreamSerialPort&&)                         = delete;
+    auto operator=(const StreamSerialPort&) -> StreamSerialPort& = delete;
+    auto operator=(StreamSerialPort&&) -> StreamSerialPort&      = delete;
+
+    [[nodiscard]] auto receive() -> std::optional<std::uint8_t> override
+    {
+        if ((rx_head_ >= rx_size_) && (!refill()))
+        {
+            return {};
+        }
+        return rx_buf_.at(rx_head_++);
+    }
+
+    [[nodiscard]] auto send(const std::uint8_t b) -> bool override
+    {
+        if ((tx_size_ >= tx_buf_.size()) && (!flushAndCompact()))
+        {
+            return false;
+        }
+        tx_buf_.at(tx_size_++) = b;
+        return true;
+    }
+
+    [[nodiscard]] auto receiveBlock(std::uint8_t* const buffer, const std::size_t capacity) -> std::size_t override
+    {
+        if ((rx_head_ >= rx_size_) && (!refill()))
+        {
+            return 0;
+        }
+        const auto out = std::min(capacity, rx_size_ - rx_head_);
+        (void) std::memcpy(buffer, &rx_buf_.at(rx_head_), out);
+        rx_head_ += out;
+        return out;
+    }
+
+    [[nodiscard]] auto sendBlock(const std::uint8_t* const data, const std::size_t size) -> std::size_t override
+    {
+        std::size_t out = 0;
+        while (out < size)
+        {
+            if ((tx_size_ >= tx_buf_.size()) && (!flushAndCompact()))
+            {
+                break;
+            }
+            const auto chunk = std::min(size - out, tx_buf_.size() - tx_size_);
+            (void) std::memcpy(&tx_buf_.at(tx_size_), data + out, chunk);  // NOLINT pointer arithmetic
+            tx_size_ += chunk;
+            out += chunk;
+        }
+        return out;
+    }
+
+    [[nodiscard]] auto getStatistics() const -> const Statistics& { return stats_; }
+
+    [[nodiscard]] auto getFileDescriptor() const -> int override { return fd_; }
+
+    [[nodiscard]] auto hasBufferedInput() const -> bool override { return rx_head_ < rx_size_; }
+
+    [[nodiscard]] auto flush() -> bool override
+    {
+        while (tx_head_ < tx_size_)
+        {
+            const auto out = writeSome(&tx_buf_.at(tx_head_), tx_size_ - tx_head_);
+            if (out <= 0)
+            {
+                break;  // Either the kernel buffer is full or an error occurred; retry later.
+            }
+            tx_head_ += static_cast<std::size_t>(out);
+            stats_.bytes_sent += static_cast<std::uint64_t>(out);
+        }
+        if (tx_head_ >= tx_size_)
+        {
+            tx_head_ = 0;
+            tx_size_ = 0;
+        }
+        return tx_size_ > 0;
+    }
+
+private:
+    [[nodiscard]] auto refill() -> bool
+    {
+        const auto out = ::read(fd_, rx_buf_.data(), rx_buf_.size());
+        rx_head_       = 0;
+        rx_size_       = (out > 0) ? static_cast<std::size_t>(out) : 0U;
+        stats_.syscalls++;
+        stats_.bytes_received += rx_size_;
+        return rx_size_ > 0;
+    }
+
+    /// Returns true if there is free space in the TX buffer afterwards.
+    [[nodiscard]] auto flushAndCompact() -> bool
+    {
+        (void) flush();
+        if (tx_head_ > 0)
+        {
+            (void) std::memmove(tx_buf_.data(), &tx_buf_.at(tx_head_), tx_size_ - tx_head_);
+            tx_size_ -= tx_head_;
+            tx_head_ = 0;
+        }
+        return tx_size_ < tx_buf_.size();
+    }
+
+    [[nodiscard]] auto writeSome(const std::uint8_t* const data, const std::size_t size) -> ::ssize_t
+    {
+        stats_.syscalls++;
+        if (is_socket_)
+        {
+            return ::send(fd_, data, size, MSG_NOSIGNAL);  // A closed connection shall not raise SIGPIPE.
+        }
+        return ::write(fd_, data, size);
+    }
+
+    const int fd_;
+    bool      is_socket_ = false;
+
+    std::array<std::uint8_t, BufferSize> rx_buf_{};
+    std::size_t                          rx_head_ = 0;
+    std::size_t                          rx_size_ = 0;
+
+    std::array<std::uint8_t, BufferSize> tx_buf_{};
+    std::size_t                          tx_head_ = 0;
+    std::size_t                          tx_size_ = 0;
+
+    Statistics stats_;
+};
+
+/// Opens a non-blocking raw CAN FD socket bound to the specified SocketCAN interface.
+/// Returns the file descriptor or -1 on failure, with errno set.
+[[nodiscard]] inline auto openSocketCAN(const char* const iface_name) -> int
+{
+    const int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    const auto fail = [fd]() {
+        const int err = errno;
+        (void) ::close(fd);
+        errno = err;
+        return -1;
+    };
+    ::ifreq ifr{};
+    (void) std::strncpy(ifr.ifr_name, iface_name, IFNAMSIZ - 1);  // NOLINT union
+    if (0 != ::ioctl(fd, SIOCGIFINDEX, &ifr))                     // NOLINT vararg
+    {
+        return fail();
+    }
+    ::sockaddr_can adr{};
+    adr.can_family  = AF_CAN;
+    adr.can_ifindex = ifr.ifr_ifindex;  // NOLINT union
+    if (0 != ::bind(fd, reinterpret_cast<::sockaddr*>(&adr), sizeof(adr)))
+    {
+        return fail();
+    }
+    const int en = 1;
+    if (0 != ::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &en, sizeof(en)))
+    {
+        return fail();  // CAN FD is not supported by the interface.
+    }
+    return fd;
+}
+
+/// ICANDriver over a raw SocketCAN socket obtained from openSocketCAN(). The bit rate is configured externally.
+/// The acceptance filters are installed into the kernel as CAN_RAW_FILTER, so the irrelevant traffic does not even
+/// reach the process. The frames are exchanged with the kernel in batches using sendmmsg()/recvmmsg():
+/// push() only enqueues the frame, and the TX queue is written out by flush(), which EpollRunner invokes after every
+/// poll of the bootloader. If the kernel cannot accept more frames, they stay queued, and push() reports the lack of
+/// space once the queue is full instead of dropping frames silently. If the queueing discipline of the interface is
+/// full (ENOBUFS), the socket stays writable, so the transmission is retried after TxRetryInterval instead.
+/// A frame rejected by the kernel for any other reason (e.g., an FD frame on a Classic CAN interface) is dropped so
+/// that it does not block the queue. Frames that could not be sent within TxTimeout are discarded as required by
+/// ICANDriver. The file descriptor is closed on destruction.
+class SocketCANDriver final : public can::ICANDriver, public IEventSource
+{
+public:
+    /// The number of frames exchanged with the kernel per syscall; this is also the depth of the TX queue.
+    static constexpr std::size_t BatchSize = 64;
+
+    /// The kernel applies up to this many acceptance filters.
+    static constexpr std::size_t MaxAcceptanceFilters = 16;
+
+    static constexpr std::chrono::milliseconds TxTimeout{1'000};
+
+    /// How long to wait before retrying if the interface queue is full; see getRetryTime().
+    static constexpr std::chrono::milliseconds TxRetryInterval{5};
+
+    struct Params final
+    {
+        /// SO_SNDBUF and SO_RCVBUF of the socket in bytes; zero keeps the system default.
+        /// The receive buffer should accommodate the traffic that may arrive between two polls of the bootloader.
+        int send_buffer_size    = 0;
+        int receive_buffer_size = 0;
+    };
+
+    struct Statistics final
+    {
+        std::uint64_t frames_sent     = 0;
+        std::uint64_t frames_received = 0;  ///< Only the frames that passed the filters and were returned by pop().
+        std::uint64_t tx_queue_full   = 0;  ///< The number of times push() was rejected due to lack of space.
+        std::uint64_t tx_timeouts     = 0;  ///< Frames discarded because the kernel did not accept them in time.
+        std::uint64_t tx_errors       = 0;  ///< Frames discarded because the kernel rejected them.
+        std::uint64_t syscalls        = 0;  ///< The number of sendmmsg() and recvmmsg() invocations.
+    };
+
+    explicit SocketCANDriver(const int fd) : SocketCANDriver(fd, Params{}) {}
+
+    /// The buffer sizes are applied on a best-effort basis; see SO_SNDBUF/SO_RCVBUF for the limits.
+    SocketCANDriver(const int fd, const Params& params) : fd_(fd)
+    {
+        if (params.send_buffer_size > 0)
+        {
+            (void) ::setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &params.send_buffer_size, sizeof(int));
+        }
+        if (params.receive_buffer_size > 0)
+        {
+            (void) ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &params.receive_buffer_size, sizeof(int));
+        }
+    }
+
+    ~SocketCANDriver() override { (void) ::close(fd_); }
+
+    SocketCANDriver(const SocketCANDriver&)                    = delete;
+    SocketCANDriver(SocketCANDriver&&)                         = delete;
+    auto operator=(const SocketCANDriver&) -> SocketCANDriver& = delete;
+    auto operator=(SocketCANDriver&&) -> SocketCANDriver&      = delete;
+
+    [[nodiscard]] auto configure(const Bitrate&                        bitrate,
+                                 const bool                            silent,
+                                 const can::CANAcceptanceFilterConfig& filter) -> std::optional<Mode> override
+    {
+        return configureMulti(bitrate, silent, 1, &filter);
+    }
+
+    [[nodiscard]] auto getMaxAcceptanceFilters() const -> std::size_t override { return MaxAcceptanceFilters; }
+
+    /// The kernel accepts a frame if it matches any of the filters. Only extended data frames are accepted.
+    /// SocketCAN offers no listen-only mode per socket, so in the silent mode the driver refuses to transmit.
+    /// The pending TX and RX frames are discarded because they belong to the previous configuration.
+    [[nodiscard]] auto configureMulti(const Bitrate&                              bitrate,
+                                      const bool                                  silent,
+                                      const std::size_t                           num_filters,
+                                      const can::CANAcceptanceFilterConfig* const filters)
+        -> std::optional<Mode> override
+    {
+        (void) bitrate;
+        KOCHERGA_ASSERT((num_filters > 0) && (num_filters <= MaxAcceptanceFilters) && (filters != nullptr));
+        std::array<::can_filter, MaxAcceptanceFilters> kernel_filters{};
+        const auto                                     count = std::min(num_filters, MaxAcceptanceFilters);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            const auto& f = filters[i];  // NOLINT NOSONAR pointer arithmetic
+            kernel_filters.at(i).can_id   = (f.extended_can_id & CAN_EFF_MASK) | CAN_EFF_FLAG;
+            kernel_filters.at(i).can_mask = (f.mask & CAN_EFF_MASK) | CAN_EFF_FLAG | CAN_RTR_FLAG;
+        }
+        const auto size = static_cast<::socklen_t>(count * sizeof(::can_filter));
+        if (0 != ::setsockopt(fd_, SOL_CAN_RAW, CAN_RAW_FILTER, kernel_filters.data(), size))
+        {
+            return {};
+        }
+        silent_   = silent;
+        tx_head_  = 0;
+        tx_size_  = 0;
+        retry_at_.reset();
+        rx_head_  = 0;
+        rx_count_ = 0;
+        return Mode::FD;
+    }
+
+    [[nodiscard]] auto push(const bool          force_classic_can,
+                            const std::uint32_t extended_can_id,
+                            const std::uint8_t  payload_size,
+                            const void* const   payload) -> bool override
+    {
+        if (silent_ || (payload_size > CANFD_MAX_DLEN))
+        {
+            return false;
+        }
+        if (tx_size_ >= tx_queue_.size())
+        {
+            (void) flush();
+        }
+        if (tx_size_ >= tx_queue_.size())
+        {
+            stats_.tx_queue_full++;
+            return false;
+        }
+        TxItem& item      = tx_queue_.at((tx_head_ + tx_size_) % tx_queue_.size());
+        item.frame        = {};
+        item.frame.can_id = extended_can_id | CAN_EFF_FLAG;
+        item.frame.len    = payload_size;
+        item.frame.flags  = force_classic_can ? 0 : CANFD_BRS;
+        item.classic      = force_classic_can;
+        item.deadline     = std::chrono::steady_clock::now() + TxTimeout;
+        (void) std::memcpy(item.frame.data, payload, payload_size);
+        tx_size_++;
+        return true;
+    }
+
+    [[nodiscard]] auto pop(PayloadBuffer& payload_buffer)
+        -> std::optional<std::pair<std::uint32_t, std::uint8_t>> override
+    {
+        while (true)
+        {
+            if ((rx_head_ >= rx_count_) && (!receiveBatch()))
+            {
+                return {};
+            }
+            const ::canfd_frame& frame = rx_frames_.at(rx_head_++);
+            if (((frame.can_id & CAN_EFF_FLAG) != 0) &&  //
+                ((frame.can_id & CAN_ERR_FLAG) == 0) &&  //
+                ((frame.can_id & CAN_RTR_FLAG) == 0))
+            {
+                const auto len = std::min<std::uint8_t>(frame.len, static_cast<std::uint8_t>(payload_buffer.size()));
+                (void) std::memcpy(payload_buffer.data(), frame.data, len);
+                stats_.frames_received++;
+                return std::pair{frame.can_id & CAN_EFF_MASK, len};
+            }
+        }
+    }
+
+    [[nodiscard]] auto getFileDescriptor() const -> int override { return fd_; }
+
+    [[nodiscard]] auto hasBufferedInput() const -> bool override { return rx_head_ < rx_count_; }
+
+    /// Writes the TX queue out to the kernel in as few syscalls as possible; returns true if frames remain queued.
+    [[nodiscard]] auto flush() -> bool override
+    {
+        const auto now = std::chrono::steady_clock::now();
+        while ((tx_size_ > 0) && (tx_queue_.at(tx_head_).deadline < now))
+        {
+            stats_.tx_timeouts++;
+            tx_head_ = (tx_head_ + 1U) % tx_queue_.size();
+            tx_size_--;
+        }
+        if (retry_at_ && (now < *retry_at_))
+        {
+            return false;  // Nothing to wait for on the fd, the runner is going to invoke flush() again in time.
+        }
+        retry_at_.reset();
+        while (tx_size_ > 0)
+        {
+            std::array<::mmsghdr, BatchSize> msgs{};
+            std::array<::iovec, BatchSize>   iovs{};
+            for (std::size_t i = 0; i < tx_size_; i++)
+            {
+                TxItem& item                  = tx_queue_.at((tx_head_ + i) % tx_queue_.size());
+                iovs.at(i).iov_base           = &item.frame;
+                iovs.at(i).iov_len            = item.classic ? CAN_MTU : CANFD_MTU;
+                msgs.at(i).msg_hdr.msg_iov    = &iovs.at(i);
+                msgs.at(i).msg_hdr.msg_iovlen = 1;
+            }
+            stats_.syscalls++;
+            const int sent = ::sendmmsg(fd_, msgs.data(), static_cast<unsigned int>(tx_size_), MSG_DONTWAIT);
+            if (sent <= 0)
+            {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+                {
+                    break;  // The socket buffer is full; retry once the socket is writable.
+                }
+                if (errno == ENOBUFS)
+                {
+                    retry_at_ = now + TxRetryInterval;  // The interface queue is full but the socket stays writable.
+                    return false;
+                }
+                if (errno != EINTR)
+                {
+                    stats_.tx_errors++;  // The frame cannot be sent at all; do not let it block the others.
+                    tx_head_ = (tx_head_ + 1U) % tx_queue_.size();
+                    tx_size_--;
+                }
+                continue;
+            }
+            stats_.frames_sent += static_cast<std::uint64_t>(sent);
+            tx_head_ = (tx_head_ + static_cast<std::size_t>(sent)) % tx_queue_.size();
+            tx_size_ -= static_cast<std::size_t>(sent);
+        }
+        return tx_size_ > 0;
+    }
+
+    [[nodiscard]] auto getRetryTime() const -> std::optional<std::chrono::steady_clock::time_point> override
+    {
+        return (tx_size_ > 0) ? retry_at_ : std::nullopt;
+    }
+
+    [[nodiscard]] auto getStatistics() const -> const Statistics& { return stats_; }
+
+private:
+    struct TxItem final
+    {
+        ::canfd_frame                         frame;
+        bool                                  classic;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    [[nodiscard]] auto receiveBatch() -> bool
+    {
+        std::array<::mmsghdr, BatchSize> msgs{};
+        std::array<::iovec, BatchSize>   iovs{};
+        for (std::size_t i = 0; i < BatchSize; i++)
+        {
+            iovs.at(i).iov_base           = &rx_frames_.at(i);
+            iovs.at(i).iov_len            = sizeof(::canfd_frame);
+            msgs.at(i).msg_hdr.msg_iov    = &iovs.at(i);
+            msgs.at(i).msg_hdr.msg_iovlen = 1;
+        }
+        stats_.syscalls++;
+        const int received = ::recvmmsg(fd_, msgs.data(), static_cast<unsigned int>(BatchSize), MSG_DONTWAIT, nullptr);
+        rx_head_           = 0;
+        rx_count_          = (received > 0) ? static_cast<std::size_t>(received) : 0U;
+        for (std::size_t i = 0; i < rx_count_; i++)
+        {
+            if (msgs.at(i).msg_len == CAN_MTU)  // Classic CAN frames do not initialize the FD-specific fields.
+            {
+                rx_frames_.at(i).flags = 0;
+            }
+        }
+        return rx_count_ > 0;
+    }
+
+    const int  fd_;
+    bool       silent_ = false;
+    Statistics stats_;
+
+    std::array<TxItem, BatchSize> tx_queue_{};
+    std::size_t                   tx_head_ = 0;
+    std::size_t                   tx_size_ = 0;
+
+    std::optional<std::chrono::steady_clock::time_point> retry_at_;
+
+    std::array<::canfd_frame, BatchSize> rx_frames_{};
+    std::size_t                          rx_head_  = 0;
+    std::size_t                          rx_count_ = 0;
+};
+
+/// Runs the bootloader in an event loop that sleeps until a registered file descriptor becomes ready or until the
+/// next deadline reported by the bootloader, whichever is earlier; there is no fixed polling period.
+/// Sources that hang up are no longer waited for; their nodes stay idle. An error condition is not terminal:
+/// the source stays registered and consumes the error on its next read (e.g., a transient ENETDOWN on SocketCAN).
+class EpollRunner final
+{
+public:
+    static constexpr std::size_t MaxSources = 8;
+
+    /// How long the output is allowed to drain after the bootloader has arrived at a final state.
+    static constexpr std::chrono::milliseconds DrainTimeout{1'000};
+
+    EpollRunner() : epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), started_at_(std::chrono::steady_clock::now()) {}
+
+    ~EpollRunner()
+    {
+        if (epoll_fd_ >= 0)
+        {
+            (void) ::close(epoll_fd_);
+        }
+    }
+
+    EpollRunner(const EpollRunner&)                    = delete;
+    EpollRunner(EpollRunner&&)                         = delete;
+    auto operator=(const EpollRunner&) -> EpollRunner& = delete;
+    auto operator=(EpollRunner&&) -> EpollRunner&      = delete;
+
+    /// False if the epoll instance could not be created; errno is set.
+    [[nodiscard]] auto isValid() const -> bool { return epoll_fd_ >= 0; }
+
+    /// The source shall outlive the runner. Returns false if there are too many sources or epoll failed (see errno).
+    [[nodiscard]] auto add(IEventSource& source) -> bool
+    {
+        if ((!isValid()) || (num_sources_ >= MaxSources))
+        {
+            return false;
+        }
+        Slot& slot = slots_.at(num_sources_);
+        slot       = Slot{&source, false, false};
+        if (!control(EPOLL_CTL_ADD, num_sources_))
+        {
+            return false;
+        }
+        num_sources_++;
+        return true;
+    }
+
+    /// The time since the construction of the runner, which is the time base of the bootloader.
+    [[nodiscard]] auto getUptime() const -> std::chrono::microseconds
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started_at_);
+    }
+
+    /// Polls the bootloader until it arrives at a final state, which is returned. The pending output is then given
+    /// at most DrainTimeout to be written out, so that, e.g., the response to a restart command is not lost.
+    /// Returns an empty option if epoll failed; errno is set.
+    template <typename Bootloader>
+    [[nodiscard]] auto run(Bootloader& boot) -> std::optional<Final>
+    {
+        while (isValid())
+        {
+            const auto fin            = boot.poll(getUptime());
+            const bool buffered_input = service();
+            if (fin)
+            {
+                (void) drain();
+                return fin;
+            }
+            auto timeout = buffered_input ? std::chrono::microseconds::zero()  //
+                                          : (boot.getNextDeadline() - getUptime());
+            if (retry_at_)
+            {
+                timeout = std::min(timeout, *retry_at_ - getUptime());
+            }
+            if (!wait(timeout))
+            {
+                return {};
+            }
+        }
+        return {};
+    }
+
+    /// Flushes the output of every source and updates the readiness subscriptions accordingly.
+    /// Returns true if any of the sources has buffered input. This is used by run() and is exposed for custom loops,
+    /// which shall also wake up by getRetryDeadline() at the latest.
+    [[nodiscard]] auto service() -> bool
+    {
+        bool buffered_input = false;
+        retry_at_.reset();
+        for (std::size_t i = 0; i < num_sources_; i++)
+        {
+            Slot& slot = slots_.at(i);
+            if (slot.closed)
+            {
+                continue;
+            }
+            const bool pending_output = slot.source->flush();
+            if (pending_output != slot.pending_output)
+            {
+                slot.pending_output = pending_output;
+                (void) control(EPOLL_CTL_MOD, i);
+            }
+            buffered_input = buffered_input || slot.source->hasBufferedInput();
+            if (const auto retry_time = slot.source->getRetryTime())
+            {
+                const auto at = std::chrono::duration_cast<std::chrono::microseconds>(*retry_time - started_at_);
+                retry_at_     = retry_at_ ? std::min(*retry_at_, at) : at;
+            }
+        }
+        return buffered_input;
+    }
+
+    /// The uptime when the output of some source is to be retried as of the last service(); see getRetryTime().
+    [[nodiscard]] auto getRetryDeadline() const -> std::optional<std::chrono::microseconds> { return retry_at_; }
+
+    /// Blocks until a source is ready or the timeout has expired; the timeout is rounded up to whole milliseconds.
+    /// Returns false if epoll failed; errno is set. Interruption by a signal is not considered a failure.
+    [[nodiscard]] auto wait(const std::chrono::microseconds timeout) -> bool
+    {
+        static constexpr std::int64_t UsPerMs = 1'000;
+        const auto ms = std::clamp<std::int64_t>((timeout.count() + UsPerMs - 1) / UsPerMs, 0, INT_MAX);
+
+        std::array<::epoll_event, MaxSources> events{};
+        const int                             num_events =
+            ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), static_cast<int>(ms));
+        if (num_events < 0)
+        {
+            return errno == EINTR;
+        }
+        for (std::size_t i = 0; i < static_cast<std::size_t>(num_events); i++)
+        {
+            // EPOLLERR is reported until the source reads the pending error (recv() clears it), which happens in the
+            // next poll of the bootloader, so it is ignored here. Only stream fds hang up, and that is final.
+            const ::epoll_event& ev = events.at(i);
+            if ((ev.events & static_cast<std::uint32_t>(EPOLLHUP | EPOLLRDHUP)) != 0)
+            {
+                Slot& slot  = slots_.at(ev.data.u32);
+                slot.closed = true;
+                (void) ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, slot.source->getFileDescriptor(), nullptr);
+            }
+        }
+        return true;
+    }
+
+private:
+    struct Slot final
+    {
+        IEventSource* source;
+        bool          pending_output;
+        bool          closed;
+    };
+
+    [[nodiscard]] auto control(const int op, const std::size_t index) -> bool
+    {
+        const Slot&   slot = slots_.at(index);
+        ::epoll_event ev{};
+        ev.events   = static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP) |
+                    (slot.pending_output ? static_cast<std::uint32_t>(EPOLLOUT) : 0U);
+        ev.data.u32 = static_cast<std::uint32_t>(index);
+        return 0 == ::epoll_ctl(epoll_fd_, op, slot.source->getFileDescriptor(), &ev);
+    }
+
+    /// Returns true if all output has been written out.
+    [[nodiscard]] auto drain() -> bool
+    {
+        const auto deadline = getUptime() + DrainTimeout;
+        while (true)
+        {
+            (void) service();
+            bool pending = retry_at_.has_value();
+            for (std::size_t i = 0; i < num_sources_; i++)
+            {
+                pending = pending || (slots_.at(i).pending_output && !slots_.at(i).closed);
+            }
+            const auto now   = getUptime();
+            const auto until = retry_at_ ? std::min(deadline, *retry_at_) : deadline;
+            if ((!pending) || (now >= deadline) || (!wait(until - now)))
+            {
+                return !pending;
+            }
+        }
+    }
+
+    const int                                   epoll_fd_;
+    const std::chrono::steady_clock::time_point started_at_;
+    std::array<Slot, MaxSources>                slots_{};
+    std::size_t                                 num_sources_ = 0;
+    std::optional<std::chrono::microseconds>    retry_at_;  ///< As of the last service().
+};
+
+}  // namespace kocherga::os_linux
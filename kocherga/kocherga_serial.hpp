@@ -5,6 +5,7 @@
 #pragma once
 
 #include "kocherga.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <variant>
 
@@ -12,16 +13,34 @@ namespace kocherga::serial
 {
 namespace detail
 {
-using kocherga::detail::BitsPerByte;  // NOSONAR
-using kocherga::detail::CRC16CCITT;   // NOSONAR
-using kocherga::detail::CRC32C;       // NOSONAR
+using kocherga::detail::BitsPerByte;       // NOSONAR
+using kocherga::detail::CRC16CCITT;        // NOSONAR
+using kocherga::detail::CRC32C;            // NOSONAR
+using kocherga::detail::ResponseCRCCache;  // NOSONAR
 
 constexpr std::uint8_t FrameDelimiter = 0x00;  ///< Zeros cannot occur inside frames thanks to COBS encoding.
 
 /// Reference values to check the header against.
 static constexpr std::uint8_t                FrameFormatVersion = 1;
 static constexpr std::array<std::uint8_t, 4> FrameIndexEOTReference{0, 0, 0, 0x80};
-static constexpr std::array<std::uint8_t, 2> UserData{0, 0};
+static constexpr std::size_t                 FrameHeaderSize = 24;  ///< Including the header CRC.
+
+/// Forward error correction (FEC) is an optional extension for lossy links, such as radio modems or long RS-485 lines,
+/// where a single damaged byte would otherwise cost a whole frame and a retry. It is signaled by a flag in the user
+/// data field of the header and applies to the frame body (the payload followed by the transfer CRC) before COBS.
+/// The body is split into blocks of FECBlockSize bytes (the last one may be shorter), each followed by its CRC16;
+/// the blocks are followed by the parity block, which is the XOR of all blocks (as long as the first one),
+/// followed by its CRC16. A frame where at most one block (parity included) is damaged is restored.
+/// Damage to the header, or a byte turned into a frame delimiter, cannot be corrected.
+static constexpr std::uint16_t UserDataFlagFEC = 1U;
+static constexpr std::size_t   FECBlockSize    = 32;  ///< Trades the CRC overhead off against the parity overhead.
+
+/// The size of the frame body with FEC applied, given its size without FEC (the payload size plus the CRC size).
+[[nodiscard]] constexpr auto getFECBodySize(const std::size_t size) -> std::size_t
+{
+    const auto block_count = (size + FECBlockSize - 1U) / FECBlockSize;
+    return size + (block_count * CRC16CCITT::Size) + std::min(size, FECBlockSize) + CRC16CCITT::Size;
+}
 
 /// New instance shall be created per encoded frame.
 /// ByteWriter is of type (std::uint8_t) -> bool, returns true on success.
@@ -121,6 +140,88 @@ private:
     ByteWriter    byte_writer_;
 };
 
+/// Block-oriented equivalent of COBSEncoder that produces an identical output.
+/// The zero bytes are located using std::memchr(), which the standard libraries implement with word-wise or SIMD
+/// scanning, and every run between them is emitted with a single writer invocation instead of one per byte.
+/// Runs that are entirely contained in one input fragment are forwarded to the writer without copying.
+/// New instance shall be created per encoded frame.
+/// BlockWriter is of type (const std::uint8_t*, std::size_t) -> bool, returns true on success.
+template <typename BlockWriter>
+class COBSBlockEncoder
+{
+public:
+    explicit COBSBlockEncoder(BlockWriter block_writer) : block_writer_(block_writer) {}
+
+    /// Invoke this function with consecutive fragments of the frame; the fragments may be of any size.
+    /// The leading frame delimiter will be added automatically.
+    /// The instance shall be discarded immediately if this method returns false.
+    [[nodiscard]] auto push(const std::uint8_t* data, std::size_t size) -> bool
+    {
+        if ((!started_) && (size > 0))
+        {
+            started_ = true;
+            if (!output(&FrameDelimiter, 1))
+            {
+                return false;
+            }
+        }
+        while (size > 0)
+        {
+            const auto  limit  = std::min(size, MaxRunLength - run_length_);
+            const auto* zero   = static_cast<const std::uint8_t*>(std::memchr(data, FrameDelimiter, limit));
+            const auto  length = (zero != nullptr) ? static_cast<std::size_t>(zero - data) : limit;
+            const bool  done   = (zero != nullptr) || ((run_length_ + length) >= MaxRunLength);
+            if (done && (run_length_ == 0))
+            {
+                if (!emit(data, length))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                (void) std::memcpy(&run_.at(run_length_), data, length);
+                run_length_ += length;
+                if (done && (!emit(run_.data(), run_length_)))
+                {
+                    return false;
+                }
+            }
+            const auto consumed = length + ((zero != nullptr) ? 1U : 0U);
+            data += consumed;  // NOLINT pointer arithmetic
+            size -= consumed;
+        }
+        return true;
+    }
+
+    /// This function shall be invoked at the end once.
+    /// The trailing frame delimiter will be added automatically.
+    /// The instance shall be discarded immediately if this method returns false.
+    [[nodiscard]] auto end() -> bool { return emit(run_.data(), run_length_) && output(&FrameDelimiter, 1); }
+
+private:
+    [[nodiscard]] auto output(const std::uint8_t* const data, const std::size_t size) const -> bool
+    {
+        return block_writer_(data, size);
+    }
+
+    /// Outputs the code byte followed by the run of non-zero bytes.
+    [[nodiscard]] auto emit(const std::uint8_t* const data, const std::size_t size) -> bool
+    {
+        KOCHERGA_ASSERT(size <= MaxRunLength);
+        const auto code = static_cast<std::uint8_t>(size + 1U);
+        run_length_     = 0;
+        return output(&code, 1) && ((size == 0) || output(data, size));
+    }
+
+    static constexpr std::size_t MaxRunLength = std::numeric_limits<std::uint8_t>::max() - 1U;
+
+    std::array<std::uint8_t, MaxRunLength> run_;
+    std::size_t                            run_length_ = 0;
+    bool                                   started_    = false;
+    BlockWriter                            block_writer_;
+};
+
 /// Constant-complexity COBS stream decoder extracts useful payload from a COBS-encoded stream of bytes in real time.
 /// It does not perform any error checking; the outer logic is responsible for that (e.g., using CRC).
 /// The implementation is derived from "Consistent Overhead Byte Stuffing" by Stuart Cheshire and Mary Baker, 1999.
@@ -167,6 +268,145 @@ private:
     std::uint8_t                  copy_ = 0;
 };
 
+/// Applies FEC to the frame body; see FECBlockSize. New instance shall be created per frame.
+/// The data is forwarded to the writer without copying; only the parity block is accumulated internally.
+/// BlockWriter is of type (const std::uint8_t*, std::size_t) -> bool, returns true on success.
+template <typename BlockWriter>
+class FECEncoder
+{
+public:
+    /// The size of the body shall be known in advance because it defines the size of the parity block.
+    FECEncoder(BlockWriter block_writer, const std::size_t body_size) :
+        parity_size_(std::min(body_size, FECBlockSize)), block_writer_(block_writer)
+    {}
+
+    /// Invoke this function with consecutive fragments of the body; the fragments may be of any size.
+    /// The instance shall be discarded immediately if this method returns false.
+    [[nodiscard]] auto push(const std::uint8_t* data, std::size_t size) -> bool
+    {
+        while (size > 0)
+        {
+            const auto length = std::min(size, FECBlockSize - block_offset_);
+            for (std::size_t i = 0; i < length; i++)
+            {
+                parity_.at(block_offset_ + i) ^= data[i];  // NOLINT pointer arithmetic
+            }
+            block_crc_.update(length, data);
+            if (!block_writer_(data, length))
+            {
+                return false;
+            }
+            block_offset_ += length;
+            data += length;  // NOLINT pointer arithmetic
+            size -= length;
+            if ((block_offset_ >= FECBlockSize) && (!endBlock()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Completes the last block and emits the parity block. This function shall be invoked at the end once.
+    /// The instance shall be discarded immediately if this method returns false.
+    [[nodiscard]] auto end() -> bool
+    {
+        if ((block_offset_ > 0) && (!endBlock()))
+        {
+            return false;
+        }
+        block_crc_.update(parity_size_, parity_.data());
+        return block_writer_(parity_.data(), parity_size_) && endBlock();
+    }
+
+private:
+    [[nodiscard]] auto endBlock() -> bool
+    {
+        const auto crc = block_crc_.getBytes();
+        block_crc_     = {};
+        block_offset_  = 0;
+        return block_writer_(crc.data(), crc.size());
+    }
+
+    std::array<std::uint8_t, FECBlockSize> parity_{};
+    CRC16CCITT                             block_crc_;
+    std::size_t                            block_offset_ = 0;
+    std::size_t                            parity_size_;
+    BlockWriter                            block_writer_;
+};
+
+struct FECDecodeResult
+{
+    std::size_t size      = 0;      ///< Of the body without FEC.
+    bool        corrected = false;  ///< A damaged data block has been restored from the parity.
+};
+
+/// Reverses FECEncoder in place: the body is restored if at most one block is damaged and moved to the beginning
+/// of the buffer. Returns empty if the damage cannot be corrected or the size is not valid.
+/// The result shall be verified using the transfer CRC because a block CRC may miss the damage.
+[[nodiscard]] inline auto decodeFEC(std::uint8_t* const buffer, const std::size_t size)
+    -> std::optional<FECDecodeResult>
+{
+    constexpr auto Stride = FECBlockSize + CRC16CCITT::Size;
+    // The size with FEC is strictly increasing with the size without, so the latter is derived and then verified.
+    std::size_t body_size = 0;
+    if (size <= ((FECBlockSize * 2U) + (CRC16CCITT::Size * 2U)))
+    {
+        body_size = (size / 2U) - std::min(size / 2U, CRC16CCITT::Size);  // One block plus its copy as parity.
+    }
+    else
+    {
+        const auto rest = size - Stride;  // Without the parity block.
+        body_size       = rest - (((rest + Stride - 1U) / Stride) * CRC16CCITT::Size);
+    }
+    if ((body_size == 0) || (getFECBodySize(body_size) != size))
+    {
+        return {};
+    }
+    const auto block_count = (body_size + FECBlockSize - 1U) / FECBlockSize;
+    const auto parity_size = std::min(body_size, FECBlockSize);
+    const auto get_offset  = [body_size](const std::size_t index) {
+        return std::min(index * FECBlockSize, body_size) + (index * CRC16CCITT::Size);
+    };
+    const auto get_size = [body_size, block_count, parity_size](const std::size_t index) {
+        return (index < block_count) ? std::min(FECBlockSize, body_size - (index * FECBlockSize)) : parity_size;
+    };
+    std::optional<std::size_t> damaged;
+    for (std::size_t i = 0; i <= block_count; i++)  // The parity block is the last one.
+    {
+        CRC16CCITT crc;
+        crc.update(get_size(i) + CRC16CCITT::Size, buffer + get_offset(i));  // NOLINT pointer arithmetic
+        if (!crc.isResidueCorrect())
+        {
+            if (damaged)
+            {
+                return {};
+            }
+            damaged = i;
+        }
+    }
+    const bool corrected = damaged && (*damaged < block_count);
+    if (corrected)
+    {
+        std::uint8_t* const target = buffer + get_offset(*damaged);  // NOLINT pointer arithmetic
+        const auto          size_d = get_size(*damaged);
+        (void) std::memmove(target, buffer + get_offset(block_count), size_d);  // NOLINT pointer arithmetic
+        for (std::size_t i = 0; i < block_count; i++)
+        {
+            const std::uint8_t* const block = buffer + get_offset(i);  // NOLINT pointer arithmetic
+            for (std::size_t k = 0; (i != *damaged) && (k < std::min(size_d, get_size(i))); k++)
+            {
+                target[k] ^= block[k];  // NOLINT pointer arithmetic
+            }
+        }
+    }
+    for (std::size_t i = 1; i < block_count; i++)
+    {
+        (void) std::memmove(buffer + (i * FECBlockSize), buffer + get_offset(i), get_size(i));  // NOLINT
+    }
+    return FECDecodeResult{body_size, corrected};
+}
+
 struct Transfer
 {
     struct Metadata
@@ -183,6 +423,7 @@ struct Transfer
         NodeID        destination = AnonymousNodeID;
         std::uint16_t data_spec   = std::numeric_limits<std::uint16_t>::max();
         TransferID    transfer_id = std::numeric_limits<TransferID>::max();
+        bool          fec         = false;  ///< The body is protected by FEC; see FECBlockSize.
 
         [[nodiscard]] auto isRequest() const noexcept -> std::optional<PortID>
         {
@@ -201,6 +442,16 @@ struct Transfer
             }
             return {};
         }
+
+        /// Service transfers shall be addressed and shall not be anonymous; messages shall not be addressed.
+        [[nodiscard]] auto isValid() const noexcept -> bool
+        {
+            if (isResponse() || isRequest())
+            {
+                return (source != AnonymousNodeID) && (destination != AnonymousNodeID);
+            }
+            return destination == AnonymousNodeID;
+        }
     };
     Metadata            meta{};
     std::size_t         payload_len = 0;
@@ -222,13 +473,16 @@ public:
         const auto              dec = decoder_.feed(stream_byte);
         if (std::holds_alternative<COBSDecoder::Delimiter>(dec))
         {
-            if (inside_ && (offset_ >= TotalOverheadSize) && transfer_crc_.isResidueCorrect() && isMetaValid())
+            if (inside_ && (offset_ >= TotalOverheadSize) && meta_.isValid())
             {
-                out = Transfer{
-                    meta_,
-                    offset_ - TotalOverheadSize,
-                    buf_.data(),
-                };
+                if (const auto body_size = getBodySize())
+                {
+                    out = Transfer{
+                        meta_,
+                        *body_size - CRC32C::Size,
+                        buf_.data(),
+                    };
+                }
             }
             reset();
             inside_ = true;
@@ -274,6 +528,28 @@ public:
     }
 
 private:
+    /// Returns the size of the payload with its CRC if the body is intact or has been restored by FEC.
+    [[nodiscard]] auto getBodySize() -> std::optional<std::size_t>
+    {
+        std::size_t size = offset_ - HeaderSize;
+        if (meta_.fec)
+        {
+            const auto res = decodeFEC(buf_.data(), size);
+            if (!res)
+            {
+                return {};
+            }
+            size          = res->size;
+            transfer_crc_ = {};
+            transfer_crc_.update(size, buf_.data());
+        }
+        if ((size > (MaxPayloadSize + CRC32C::Size)) || (!transfer_crc_.isResidueCorrect()))
+        {
+            return {};
+        }
+        return size;
+    }
+
     void acceptHeader(const std::uint8_t bt)
     {
         if ((OffsetVersion == offset_) && (bt != FrameFormatVersion))
@@ -293,6 +569,10 @@ private:
         {
             reset();
         }
+        if (OffsetUserData == offset_)
+        {
+            meta_.fec = (bt & UserDataFlagFEC) != 0;
+        }
         if (offset_ == (HeaderSize - 1U))
         {
             if (!header_crc_.isResidueCorrect())
@@ -323,17 +603,7 @@ private:
         }
     }
 
-    [[nodiscard]] auto isMetaValid() const -> bool
-    {
-        if (meta_.isResponse() || meta_.isRequest())
-        {
-            return (meta_.source != Transfer::Metadata::AnonymousNodeID) &&
-                   (meta_.destination != Transfer::Metadata::AnonymousNodeID);
-        }
-        return meta_.destination == Transfer::Metadata::AnonymousNodeID;
-    }
-
-    static constexpr std::size_t HeaderSize        = 24;
+    static constexpr std::size_t HeaderSize        = FrameHeaderSize;
     static constexpr std::size_t TotalOverheadSize = HeaderSize + CRC32C::Size;
     // Header field offsets.
     static constexpr std::size_t                         OffsetVersion  = 0;
@@ -343,73 +613,542 @@ private:
     static constexpr std::pair<std::size_t, std::size_t> OffsetDataSpec{6, 7};
     static constexpr std::pair<std::size_t, std::size_t> OffsetTransferID{8, 15};
     static constexpr std::pair<std::size_t, std::size_t> OffsetFrameIndexEOT{16, 19};
+    static constexpr std::size_t                         OffsetUserData = 20;  ///< The flags are in the first byte.
+
+    COBSDecoder                                                             decoder_;
+    std::size_t                                                             offset_ = 0;
+    bool                                                                    inside_ = false;
+    CRC16CCITT                                                              header_crc_;
+    CRC32C                                                                  transfer_crc_;
+    Transfer::Metadata                                                      meta_;
+    std::array<std::uint8_t, getFECBodySize(MaxPayloadSize + CRC32C::Size)> buf_{};
+};
+
+/// Keeps the last accepted transfer-ID per session specifier (source node-ID, data specifier) to discard
+/// the duplicates produced by redundant transmissions. Unlike tracking only the last transfer, this is immune to
+/// interleaving: (A, A, B, B, A) yields (A, B). When the table is full, the least recently accepted session is evicted.
+template <std::size_t Capacity>
+class TransferIDTable
+{
+public:
+    /// Returns true if the transfer shall be accepted, in which case it is recorded; false if it is a duplicate.
+    /// A repeated transfer-ID is accepted again once the transfer-ID timeout has expired since the last acceptance.
+    [[nodiscard]] auto accept(const Transfer::Metadata& meta, const std::chrono::microseconds uptime) -> bool
+    {
+        auto* victim = &sessions_.front();
+        for (auto& ses : sessions_)
+        {
+            if (ses && (ses->source == meta.source) && (ses->data_spec == meta.data_spec))
+            {
+                const bool duplicate = (ses->transfer_id == meta.transfer_id) &&
+                                       ((ses->timestamp + ::kocherga::detail::DefaultTransferIDTimeout) >= uptime);
+                if (!duplicate)
+                {
+                    ses->transfer_id = meta.transfer_id;
+                    ses->timestamp   = uptime;
+                }
+                return !duplicate;
+            }
+            if ((*victim) && ((!ses) || (ses->timestamp < (*victim)->timestamp)))
+            {
+                victim = &ses;
+            }
+        }
+        *victim = Session{meta.source, meta.data_spec, meta.transfer_id, uptime};
+        return true;
+    }
+
+private:
+    struct Session
+    {
+        NodeID                    source{};
+        PortID                    data_spec{};
+        TransferID                transfer_id{};
+        std::chrono::microseconds timestamp{};
+    };
 
-    COBSDecoder                                             decoder_;
-    std::size_t                                             offset_ = 0;
-    bool                                                    inside_ = false;
-    CRC16CCITT                                              header_crc_;
-    CRC32C                                                  transfer_crc_;
+    static_assert(Capacity > 0);
+    std::array<std::optional<Session>, Capacity> sessions_{};
+};
+
+/// Parses the header of a Cyphal/serial frame; the layout mirrors transmitBlocks(). Returns empty if not valid.
+/// The header pointer shall point to FrameHeaderSize bytes.
+[[nodiscard]] inline auto parseHeader(const std::uint8_t* const header) -> std::optional<Transfer::Metadata>
+{
+    CRC16CCITT crc;
+    crc.update(FrameHeaderSize, header);
+    const std::uint8_t* ptr = header;
+    const auto          get = [&ptr](const std::size_t size) {
+        std::uint64_t out = 0;
+        for (std::size_t i = 0U; i < size; i++)
+        {
+            out |= static_cast<std::uint64_t>(*ptr++) << (BitsPerByte * i);  // NOLINT pointer arithmetic
+        }
+        return out;
+    };
+    if ((!crc.isResidueCorrect()) || (get(1) != FrameFormatVersion))
+    {
+        return {};
+    }
+    Transfer::Metadata meta{};
+    meta.priority    = static_cast<std::uint8_t>(get(1));
+    meta.source      = static_cast<NodeID>(get(2));
+    meta.destination = static_cast<NodeID>(get(2));
+    meta.data_spec   = static_cast<std::uint16_t>(get(2));
+    meta.transfer_id = get(sizeof(std::uint64_t));
+    if (!std::equal(FrameIndexEOTReference.begin(), FrameIndexEOTReference.end(), ptr))
+    {
+        return {};
+    }
+    ptr += FrameIndexEOTReference.size();  // NOLINT pointer arithmetic
+    meta.fec = (get(2) & UserDataFlagFEC) != 0;
+    return meta;
+}
+
+/// Block-oriented counterpart of StreamParser that yields identical transfers at a fraction of the per-byte cost.
+/// Whole COBS code blocks are copied into the frame buffer, the header is parsed in one step once it is complete,
+/// and the transfer CRC is computed over the payload span when the frame is delimited.
+template <std::size_t MaxPayloadSize>
+class BlockStreamParser
+{
+public:
+    /// Consumes a block of raw stream bytes and invokes the handler with every transfer completed within it.
+    /// Handler is of type (const Transfer&) -> void. The payload pointer is valid only until the handler returns.
+    template <typename Handler>
+    void update(const std::uint8_t* const data, const std::size_t size, const Handler& handler)
+    {
+        update(data, size, [](const Transfer::Metadata&) { return true; }, handler);
+    }
+
+    /// Same as above, but the filter is consulted as soon as the header of a frame is received and validated.
+    /// If the filter rejects the frame, the rest of it is skipped until the next delimiter: the payload is neither
+    /// buffered nor checksummed. This matters on shared links where most of the traffic is not addressed to us.
+    /// Filter is of type (const Transfer::Metadata&) -> bool, returns true to accept the frame.
+    template <typename Filter, typename Handler>
+    void update(const std::uint8_t* data, std::size_t size, const Filter& filter, const Handler& handler)
+    {
+        while (size > 0)
+        {
+            if (copy_ > 0)  // Inside a code block: copy the run up to its end or up to an unexpected delimiter.
+            {
+                const auto  limit  = std::min<std::size_t>(size, copy_);
+                const auto* zero   = static_cast<const std::uint8_t*>(std::memchr(data, FrameDelimiter, limit));
+                const auto  length = (zero != nullptr) ? static_cast<std::size_t>(zero - data) : limit;
+                accept(data, length, filter);
+                copy_ = static_cast<std::uint8_t>(copy_ - length);
+                data += length;  // NOLINT pointer arithmetic
+                size -= length;
+                frame_raw_size_ += length;
+                if (zero == nullptr)
+                {
+                    continue;
+                }
+            }
+            const auto bt = *data;
+            data++;  // NOLINT pointer arithmetic
+            size--;
+            if (bt == FrameDelimiter)
+            {
+                // The metadata has been validated upon reception of the header.
+                const bool delivered = inside_ && (offset_ >= TotalOverheadSize) && complete(handler);
+                if (!delivered)
+                {
+                    dropped_byte_count_ += frame_raw_size_;
+                }
+                reset();
+                inside_ = true;
+            }
+            else
+            {
+                frame_raw_size_++;
+                if (code_ != Top)
+                {
+                    accept(&FrameDelimiter, 1, filter);  // The zero byte removed by the encoder is restored.
+                }
+                code_ = bt;
+                copy_ = static_cast<std::uint8_t>(bt - 1U);
+            }
+        }
+    }
+
+    /// Reset the decoder state machine, drop the current incomplete frame if any.
+    void reset() noexcept
+    {
+        code_           = Top;
+        copy_           = 0;
+        offset_         = 0;
+        frame_raw_size_ = 0;
+        inside_         = false;
+        meta_           = {};
+    }
+
+    /// True if a frame that passed the header checks is being received; its remainder is likely already in transit.
+    [[nodiscard]] auto isInsideFrame() const noexcept { return inside_ && (offset_ > 0); }
+
+    /// The number of stream bytes that did not make it into a transfer: malformed, corrupted, truncated,
+    /// oversized, or rejected frames, and the noise between frames. Delimiters are not counted.
+    /// A frame is accounted for when its closing delimiter is received.
+    [[nodiscard]] auto getDroppedByteCount() const noexcept { return dropped_byte_count_; }
+
+    /// The number of frames delivered thanks to FEC.
+    [[nodiscard]] auto getCorrectedFrameCount() const noexcept { return corrected_frame_count_; }
+
+private:
+    /// Checks the body of the frame that has been received in full and passes it to the handler if it is intact
+    /// or has been restored by FEC. Returns false if the frame is dropped.
+    template <typename Handler>
+    [[nodiscard]] auto complete(const Handler& handler) -> bool
+    {
+        std::uint8_t* const body      = &frame_.at(FrameHeaderSize);
+        std::size_t         body_size = offset_ - FrameHeaderSize;
+        bool                corrected = false;
+        if (meta_.fec)
+        {
+            const auto res = decodeFEC(body, body_size);
+            if (!res)
+            {
+                return false;
+            }
+            body_size = res->size;
+            corrected = res->corrected;
+        }
+        if ((body_size < CRC32C::Size) || (body_size > (MaxPayloadSize + CRC32C::Size)))
+        {
+            return false;
+        }
+        CRC32C crc;
+        crc.update(body_size, body);
+        if (!crc.isResidueCorrect())
+        {
+            return false;
+        }
+        corrected_frame_count_ += corrected ? 1U : 0U;
+        handler(Transfer{meta_, body_size - CRC32C::Size, body});
+        return true;
+    }
+
+    /// Appends the decoded bytes to the current frame; the frame is dropped if it is malformed, too long,
+    /// or rejected by the filter.
+    template <typename Filter>
+    void accept(const std::uint8_t* const data, const std::size_t size, const Filter& filter)
+    {
+        if ((!inside_) || (size == 0))
+        {
+            return;
+        }
+        const std::uint8_t* ptr  = data;
+        std::size_t         rest = size;
+        if (offset_ < FrameHeaderSize)  // The header is completed first so that the filter sees every frame.
+        {
+            const auto length = std::min(rest, FrameHeaderSize - offset_);
+            (void) std::memcpy(&frame_.at(offset_), ptr, length);
+            offset_ += length;
+            ptr += length;  // NOLINT pointer arithmetic
+            rest -= length;
+            if (offset_ >= FrameHeaderSize)
+            {
+                const auto meta = parseHeader(frame_.data());
+                if ((!meta) || (!meta->isValid()) || (!filter(*meta)))
+                {
+                    inside_ = false;
+                    return;
+                }
+                meta_ = *meta;
+            }
+        }
+        if (rest > 0)
+        {
+            if ((offset_ + rest) > frame_.size())
+            {
+                inside_ = false;
+                return;
+            }
+            (void) std::memcpy(&frame_.at(offset_), ptr, rest);
+            offset_ += rest;
+        }
+    }
+
+    static constexpr std::size_t  TotalOverheadSize = FrameHeaderSize + CRC32C::Size;
+    static constexpr std::size_t  MaxBodySize       = getFECBodySize(MaxPayloadSize + CRC32C::Size);
+    static constexpr std::uint8_t Top               = std::numeric_limits<std::uint8_t>::max();
+
+    std::uint8_t                                            code_                  = Top;
+    std::uint8_t                                            copy_                  = 0;
+    std::size_t                                             offset_                = 0;
+    std::size_t                                             frame_raw_size_        = 0;
+    std::uint64_t                                           dropped_byte_count_    = 0;
+    std::uint64_t                                           corrected_frame_count_ = 0;
+    bool                                                    inside_                = false;
     Transfer::Metadata                                      meta_;
-    std::array<std::uint8_t, MaxPayloadSize + CRC32C::Size> buf_{};
+    std::array<std::uint8_t, FrameHeaderSize + MaxBodySize> frame_{};
 };
 
 /// Sends a transfer with minimal buffering (some buffering is required by COBS) to save memory and reduce latency.
+/// BlockWriter is of type (const std::uint8_t*, std::size_t) -> bool; it is invoked once per COBS run rather than
+/// once per byte, and returns false if the data could not be accepted in full.
+/// BlockWriter shall not be an std::function<> to avoid heap allocation.
+/// If the same payload is sent repeatedly, the caller may supply its CRC to avoid recomputing it;
+/// only the header (which contains the transfer-ID) and its CRC are then computed anew.
+template <typename BlockWriter>
+[[nodiscard]] inline auto transmitBlocks(const BlockWriter&           write_block,
+                                         const Transfer&              tr,
+                                         const std::optional<CRC32C>& payload_crc = {}) -> bool
+{
+    std::array<std::uint8_t, FrameHeaderSize> header{};
+    std::uint8_t*                             ptr = header.data();
+    const auto                                put = [&ptr](const std::uint64_t value, const std::size_t size) {
+        for (std::size_t i = 0U; i < size; i++)
+        {
+            *ptr++ = static_cast<std::uint8_t>(value >> (BitsPerByte * i));  // NOLINT pointer arithmetic
+        }
+    };
+    put(FrameFormatVersion, 1);
+    put(tr.meta.priority, 1);
+    put(tr.meta.source, 2);
+    put(tr.meta.destination, 2);
+    put(tr.meta.data_spec, 2);
+    put(tr.meta.transfer_id, sizeof(std::uint64_t));
+    ptr = std::copy(FrameIndexEOTReference.begin(), FrameIndexEOTReference.end(), ptr);
+    put(tr.meta.fec ? UserDataFlagFEC : 0U, 2);
+    CRC16CCITT header_crc;
+    header_crc.update(static_cast<std::size_t>(ptr - header.data()), header.data());
+    const auto header_crc_bytes = header_crc.getBytes();
+    (void) std::copy(header_crc_bytes.begin(), header_crc_bytes.end(), ptr);
+
+    CRC32C transfer_crc;
+    if (payload_crc)
+    {
+        transfer_crc = *payload_crc;
+    }
+    else
+    {
+        transfer_crc.update(tr.payload_len, tr.payload);
+    }
+    const auto transfer_crc_bytes = transfer_crc.getBytes();
+
+    COBSBlockEncoder<const BlockWriter&> encoder(write_block);
+    const auto                           push_body = [&tr, &transfer_crc_bytes](auto& sink) {
+        return ((tr.payload_len == 0) || sink.push(tr.payload, tr.payload_len)) &&
+               sink.push(transfer_crc_bytes.data(), transfer_crc_bytes.size());
+    };
+    if (!encoder.push(header.data(), header.size()))
+    {
+        return false;
+    }
+    if (tr.meta.fec)
+    {
+        FECEncoder fec(
+            [&encoder](const std::uint8_t* const data, const std::size_t size) { return encoder.push(data, size); },
+            tr.payload_len + CRC32C::Size);
+        return push_body(fec) && fec.end() && encoder.end();
+    }
+    return push_body(encoder) && encoder.end();
+}
+
+/// Same as transmitBlocks() but the output is emitted byte-by-byte.
 /// Callback is of type (std::uint8_t) -> bool whose semantics reflects ISerialPort::send().
 /// Callback shall not be an std::function<> to avoid heap allocation.
 template <typename Callback>
-[[nodiscard]] inline auto transmit(const Callback& send_byte, const Transfer& tr) -> bool
+[[nodiscard]] inline auto transmit(const Callback&              send_byte,
+                                   const Transfer&              tr,
+                                   const std::optional<CRC32C>& payload_crc = {}) -> bool
 {
-    COBSEncoder<const Callback&> encoder(send_byte);
-    CRC16CCITT                   header_crc;
-    const auto                   header_out = [&header_crc, &encoder](const std::uint8_t b) {
-        header_crc.update(b);
-        return encoder.push(b);
-    };
-    const auto header_out2 = [&header_out](const std::uint16_t bb) {
-        return header_out(static_cast<std::uint8_t>(bb)) && header_out(static_cast<std::uint8_t>(bb >> BitsPerByte));
-    };
+    return transmitBlocks(
+        [&send_byte](const std::uint8_t* const data, const std::size_t size) {
+            for (std::size_t i = 0U; i < size; i++)
+            {
+                if (!send_byte(data[i]))  // NOLINT pointer arithmetic
+                {
+                    return false;
+                }
+            }
+            return true;
+        },
+        tr,
+        payload_crc);
+}
+
+/// The worst-case size of a transfer encoded by transmitBlocks(), including both delimiters.
+[[nodiscard]] constexpr auto getMaxEncodedFrameSize(const std::size_t payload_size, const bool fec = false)
+    -> std::size_t
+{
+    const auto body = payload_size + CRC32C::Size;
+    const auto raw  = FrameHeaderSize + (fec ? getFECBodySize(body) : body);
+    return raw + (raw / (std::numeric_limits<std::uint8_t>::max() - 1U)) + 3U;
+}
 
-    bool ok = header_out(FrameFormatVersion) && header_out(tr.meta.priority) &&  //
-              header_out2(tr.meta.source) && header_out2(tr.meta.destination) && header_out2(tr.meta.data_spec);
-    auto tmp_transfer_id = tr.meta.transfer_id;
-    for (auto i = 0U; i < sizeof(std::uint64_t); i++)
+/// Queue of encoded frames awaiting transmission. The frames are stored back-to-back in a linear buffer,
+/// so whatever is pending can be handed over to the port with one call, and a partially sent frame is resumed
+/// where it stopped. When the space runs out, whole frames are dropped: first the expired ones, then the least
+/// urgent ones that are not more urgent than the new frame (the oldest first). A partially sent frame is never
+/// dropped to avoid corrupting the byte stream.
+template <std::size_t Capacity, std::size_t MaxFrames>
+class TxQueue
+{
+public:
+    /// Encodes the transfer and enqueues it; returns false if there is no space for it even after dropping
+    /// the frames as described above.
+    [[nodiscard]] auto push(const Transfer&                 tr,
+                            const std::optional<CRC32C>&    payload_crc,
+                            const std::chrono::microseconds now,
+                            const std::chrono::microseconds deadline) -> bool
     {
-        ok = ok && header_out(static_cast<std::uint8_t>(tmp_transfer_id));
-        tmp_transfer_id >>= BitsPerByte;
+        const auto worst_size = getMaxEncodedFrameSize(tr.payload_len, tr.meta.fec);
+        if (worst_size > Capacity)
+        {
+            dropped_frame_count_++;
+            return false;
+        }
+        dropExpired(now);
+        while ((frame_count_ >= MaxFrames) || ((Capacity - (tail_ - head_)) < worst_size))
+        {
+            if (!dropLessUrgent(tr.meta.priority))
+            {
+                dropped_frame_count_++;
+                return false;
+            }
+        }
+        if ((Capacity - tail_) < worst_size)
+        {
+            (void) std::memmove(buf_.data(), &buf_.at(head_), tail_ - head_);
+            tail_ -= head_;
+            head_ = 0;
+        }
+        const auto start = tail_;
+        const bool ok    = transmitBlocks(
+            [this](const std::uint8_t* const data, const std::size_t size) {
+                KOCHERGA_ASSERT((tail_ + size) <= Capacity);
+                (void) std::memcpy(&buf_.at(tail_), data, size);
+                tail_ += size;
+                return true;
+            },
+            tr,
+            payload_crc);
+        KOCHERGA_ASSERT(ok);
+        (void) ok;
+        frames_.at(frame_count_++) = Frame{tail_ - start, tr.meta.priority, deadline};
+        return true;
     }
-    for (const auto x : FrameIndexEOTReference)
+
+    /// Hands over as much of the pending data as the writer accepts. Expired frames are dropped first.
+    /// Writer is of type (const std::uint8_t*, std::size_t) -> std::size_t, returns the number of bytes accepted.
+    template <typename Writer>
+    void flush(const Writer& writer, const std::chrono::microseconds now)
     {
-        ok = ok && header_out(x);
+        dropExpired(now);
+        if (head_ < tail_)
+        {
+            auto sent = writer(&buf_.at(head_), tail_ - head_);
+            KOCHERGA_ASSERT(sent <= (tail_ - head_));
+            head_ += sent;
+            while ((sent > 0) && (frame_count_ > 0))
+            {
+                Frame&     fr    = frames_.front();
+                const auto chunk = std::min(sent, fr.size);
+                fr.size -= chunk;
+                sent -= chunk;
+                partial_ = fr.size > 0;
+                if (!partial_)
+                {
+                    remove(0);
+                }
+            }
+        }
+        if (head_ >= tail_)
+        {
+            head_ = 0;
+            tail_ = 0;
+        }
     }
-    for (const auto x : UserData)
+
+    [[nodiscard]] auto getFrameCount() const noexcept { return frame_count_; }
+    [[nodiscard]] auto getByteCount() const noexcept { return tail_ - head_; }
+
+    /// The number of frames that were dropped or rejected by push() since the queue was created.
+    [[nodiscard]] auto getDroppedFrameCount() const noexcept { return dropped_frame_count_; }
+
+private:
+    struct Frame
     {
-        ok = ok && header_out(x);
-    }
-    for (const auto x : header_crc.getBytes())
+        std::size_t               size = 0;  ///< Bytes not yet sent.
+        std::uint8_t              priority{};
+        std::chrono::microseconds deadline{};
+    };
+
+    [[nodiscard]] auto getFirstDroppable() const noexcept -> std::size_t { return partial_ ? 1U : 0U; }
+
+    void dropExpired(const std::chrono::microseconds now)
     {
-        ok = ok && header_out(x);
+        for (auto i = getFirstDroppable(); i < frame_count_;)
+        {
+            if (frames_.at(i).deadline < now)
+            {
+                drop(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
     }
 
-    CRC32C transfer_crc;
+    /// Drops the least urgent frame whose priority is not higher than the specified one; false if none.
+    [[nodiscard]] auto dropLessUrgent(const std::uint8_t priority) -> bool
     {
-        const auto* ptr = tr.payload;
-        for (std::size_t i = 0U; i < tr.payload_len; i++)
+        std::optional<std::size_t> victim;
+        for (auto i = getFirstDroppable(); i < frame_count_; i++)
         {
-            transfer_crc.update(*ptr);
-            ok = ok && encoder.push(*ptr);
-            ++ptr;
-            if (!ok)
+            // Higher priority value means lower urgency; the strict comparison keeps the oldest among equals.
+            if ((frames_.at(i).priority >= priority) &&
+                ((!victim) || (frames_.at(i).priority > frames_.at(*victim).priority)))
             {
-                break;
+                victim = i;
             }
         }
+        if (victim)
+        {
+            drop(*victim);
+        }
+        return victim.has_value();
     }
-    for (const auto x : transfer_crc.getBytes())
+
+    /// Removes the frame along with its data from the buffer.
+    void drop(const std::size_t index)
     {
-        ok = ok && encoder.push(x);
+        auto offset = head_;
+        for (std::size_t i = 0; i < index; i++)
+        {
+            offset += frames_.at(i).size;
+        }
+        const auto size = frames_.at(index).size;
+        (void) std::memmove(&buf_.at(offset), &buf_.at(offset) + size, tail_ - offset - size);  // NOLINT
+        tail_ -= size;
+        if (index == 0)
+        {
+            partial_ = false;
+        }
+        remove(index);
+        dropped_frame_count_++;
     }
-    return ok && encoder.end();
-}
+
+    /// Removes the descriptor only.
+    void remove(const std::size_t index)
+    {
+        for (auto i = index + 1U; i < frame_count_; i++)
+        {
+            frames_.at(i - 1U) = frames_.at(i);
+        }
+        frame_count_--;
+    }
+
+    std::array<std::uint8_t, Capacity> buf_{};
+    std::size_t                        head_ = 0;
+    std::size_t                        tail_ = 0;
+    std::array<Frame, MaxFrames>       frames_{};
+    std::size_t                        frame_count_         = 0;
+    std::uint64_t                      dropped_frame_count_ = 0;
+    bool                               partial_             = false;  ///< The first frame is partially sent.
+};
 
 }  // namespace detail
 
@@ -424,10 +1163,44 @@ public:
     [[nodiscard]] virtual auto receive() -> std::optional<std::uint8_t> = 0;
 
     /// Send a single byte into the TX queue without blocking if there is free space available.
-    /// The queue shall be at least 1 KiB deep.
+    /// The queue may be shallow because SerialNode keeps the frames that do not fit in its own TX queue.
     /// Return true if enqueued or sent successfully; return false if no space available.
     [[nodiscard]] virtual auto send(const std::uint8_t b) -> bool = 0;
 
+    /// Receive up to the specified number of bytes from the RX queue without blocking.
+    /// Return the number of bytes stored into the buffer; zero if no data is available.
+    /// The default implementation adapts the single-byte API above. Ports that receive data in blocks
+    /// (e.g., from a DMA ring buffer) should override this to hand over the data with one call.
+    [[nodiscard]] virtual auto receiveBlock(std::uint8_t* const buffer, const std::size_t capacity) -> std::size_t
+    {
+        std::size_t out = 0;
+        while (out < capacity)
+        {
+            if (const auto b = receive())
+            {
+                buffer[out++] = *b;  // NOLINT pointer arithmetic
+            }
+            else
+            {
+                break;
+            }
+        }
+        return out;
+    }
+
+    /// Send up to the specified number of bytes into the TX queue without blocking.
+    /// Return the number of bytes accepted; a value less than size means that the queue is full.
+    /// The default implementation adapts the single-byte API above. See receiveBlock() for the rationale.
+    [[nodiscard]] virtual auto sendBlock(const std::uint8_t* const data, const std::size_t size) -> std::size_t
+    {
+        std::size_t out = 0;
+        while ((out < size) && send(data[out]))  // NOLINT pointer arithmetic
+        {
+            out++;
+        }
+        return out;
+    }
+
     virtual ~ISerialPort()                             = default;
     ISerialPort()                                      = default;
     ISerialPort(const ISerialPort&)                    = delete;
@@ -437,14 +1210,91 @@ public:
 };
 
 /// Kocherga node implementing the Cyphal/serial transport.
-class SerialNode : public kocherga::INode
+/// The outgoing frames are encoded into a TX queue of the specified capacity in bytes owned by the node,
+/// which is drained into the port whenever it has space, so that a full port queue does not cause transfers to be lost.
+/// The capacity shall accommodate at least the largest frame; a few frames are needed to absorb bursts.
+template <std::size_t TxQueueCapacity>
+class BasicSerialNode : public kocherga::INode
 {
 public:
+    /// Frames that could not be sent within this time are dropped.
+    static constexpr std::chrono::microseconds TxTimeout{1'000'000};
+
+    /// The lower bound of Params::pnp_initial_request_interval; a smaller value would degenerate into flooding.
+    static constexpr std::chrono::microseconds PnPMinRequestInterval{1'000};
+
+    /// Limits the amount of incoming data processed per poll() so that a burst of traffic (or noise) does not
+    /// hold up the rest of the application. The node has no clock of its own, so a time budget is to be expressed
+    /// in bytes: the processing cost is proportional to the data size. The budget shall exceed the amount of data
+    /// arriving between polls (e.g., 93 bytes at 921600 baud polled at 1 kHz), otherwise the RX queue of the port
+    /// will eventually overflow.
+    struct Params
+    {
+        /// The number of bytes read from the port per poll().
+        std::size_t rx_budget = 1024;
+
+        /// If the budget runs out while a frame is being received, up to this many bytes more are processed to
+        /// complete it, so that the transfer is handled without waiting for the next poll. Zero disables this.
+        std::size_t rx_budget_extension = detail::getMaxEncodedFrameSize(MaxSerializedRepresentationSize, true);
+
+        /// Protect the outgoing transfers with forward error correction; see detail::FECBlockSize.
+        /// This is for lossy links where the overhead (about 20% for a 256-byte payload) pays off. The receiving side
+        /// always accepts both forms. Regardless of this setting, the responses mirror the form of the requests,
+        /// and the requests are protected if the server has last addressed us using FEC, so it is sufficient to
+        /// enable it on the remote side for the update to use FEC. Messages are protected only if this is set.
+        bool fec = false;
+
+        /// The node-ID requested in the PnP allocation messages; the allocator grants it if it is not taken.
+        /// Typically, this is the node-ID allocated in a previous session (see getLocalNodeID()), which keeps
+        /// the node-ID stable. If the node-ID can be trusted without allocation, use setLocalNodeID() instead.
+        std::optional<NodeID> pnp_preferred_node_id;
+
+        /// The interval between the PnP allocation requests starts at this value and doubles after every request
+        /// up to the maximum defined by the specification. Each interval is randomized to avoid collisions.
+        /// Tens of milliseconds speed up the allocation considerably if the allocator is already online.
+        /// It is clamped to [PnPMinRequestInterval, MaxRequestInterval], so that the requests never flood the bus.
+        std::chrono::microseconds pnp_initial_request_interval =
+            kocherga::detail::dsdl::PnPNodeIDAllocation::MaxRequestInterval;
+    };
+
+    /// The counters are never reset; use them to tune Params.
+    struct Statistics
+    {
+        std::uint64_t rx_bytes            = 0;  ///< Read from the port and processed.
+        std::uint64_t rx_frames_accepted  = 0;  ///< Relevant and intact frames delivered for processing.
+        std::uint64_t rx_frames_corrected = 0;  ///< Accepted frames that were damaged and restored by FEC.
+        std::uint64_t rx_bytes_dropped    = 0;  ///< Malformed, corrupted, or irrelevant frames and noise.
+        std::uint64_t rx_budget_exhausted = 0;  ///< Polls that used up the budget; more data may be pending.
+        std::uint64_t tx_frames_dropped   = 0;  ///< Frames that expired or did not fit into the TX queue.
+    };
+
     /// The local UID shall be the same that is passed to the bootloader. It is used for PnP node-ID allocation.
-    SerialNode(ISerialPort& port, const SystemInfo::UniqueID& local_unique_id) :
-        unique_id_(local_unique_id), port_(port)
+    BasicSerialNode(ISerialPort& port, const SystemInfo::UniqueID& local_unique_id) :
+        BasicSerialNode(port, local_unique_id, Params{})
+    {}
+
+    BasicSerialNode(ISerialPort& port, const SystemInfo::UniqueID& local_unique_id, const Params& params) :
+        unique_id_(local_unique_id),
+        params_(params),
+        port_(port),
+        pnp_request_interval_(std::clamp<std::chrono::microseconds>(
+            params.pnp_initial_request_interval,
+            PnPMinRequestInterval,
+            kocherga::detail::dsdl::PnPNodeIDAllocation::MaxRequestInterval))
     {}
 
+    /// The number of bytes in the TX queue, including those of a partially sent frame.
+    [[nodiscard]] auto getTxQueueSize() const noexcept { return tx_queue_.getByteCount(); }
+
+    [[nodiscard]] auto getStatistics() const noexcept -> Statistics
+    {
+        Statistics out          = stats_;
+        out.rx_frames_corrected = stream_parser_.getCorrectedFrameCount();
+        out.rx_bytes_dropped    = stream_parser_.getDroppedByteCount();
+        out.tx_frames_dropped   = tx_queue_.getDroppedFrameCount();
+        return out;
+    }
+
     /// Set up the local node-ID manually instead of running PnP allocation.
     /// If a manual update is triggered, this shall be done beforehand.
     /// Do not assign the local node-ID more than once. Invalid values will be ignored.
@@ -456,44 +1306,94 @@ public:
         }
     }
 
+    /// The local node-ID assigned manually or allocated via PnP; empty while the allocation is in progress.
+    /// The allocated node-ID may be persisted and passed as Params::pnp_preferred_node_id next time.
+    [[nodiscard]] auto getLocalNodeID() const noexcept -> std::optional<NodeID> { return local_node_id_; }
+
     /// Resets the state of the frame parser. Call it when the communication channel is reinitialized.
     void reset() noexcept { stream_parser_.reset(); }
 
 private:
     void poll(IReactor& reactor, const std::chrono::microseconds uptime) override
     {
-        for (auto i = 0U; i < MaxBytesToProcessPerPoll; i++)
+        uptime_              = uptime;
+        rx_budget_exhausted_ = false;
+        flush();
+        std::array<std::uint8_t, ChunkSize> chunk{};
+        std::size_t                         total = 0;
+        while (true)
         {
-            if (auto bt = port_.receive())
+            const auto limit = params_.rx_budget + (stream_parser_.isInsideFrame() ? params_.rx_budget_extension : 0U);
+            if (total >= limit)
             {
-                if (const auto tr = stream_parser_.update(*bt))
-                {
-                    processReceivedTransfer(reactor, *tr, uptime);
-                }
+                stats_.rx_budget_exhausted++;
+                rx_budget_exhausted_ = true;
+                break;
             }
-            else
+            const auto request = std::min(chunk.size(), limit - total);
+            const auto size    = port_.receiveBlock(chunk.data(), request);
+            KOCHERGA_ASSERT(size <= request);
+            stream_parser_.update(
+                chunk.data(),
+                size,
+                [this](const detail::Transfer::Metadata& meta) { return isRelevant(meta); },
+                [this, &reactor, uptime](const detail::Transfer& tr) {
+                    stats_.rx_frames_accepted++;
+                    processReceivedTransfer(reactor, tr, uptime);
+                });
+            total += size;
+            if (size < request)
             {
-                break;
+                break;  // The RX queue is drained.
             }
         }
+        stats_.rx_bytes += total;
         if ((!local_node_id_) && (uptime >= pnp_next_request_at_))
         {
             using kocherga::detail::dsdl::PnPNodeIDAllocation;
-            constexpr std::int64_t interval_usec =
-                std::chrono::duration_cast<std::chrono::microseconds>(PnPNodeIDAllocation::MaxRequestInterval).count();
-            const std::chrono::microseconds delay{(getRandomByte() * interval_usec) /
+            // The interval is randomized to avoid collisions with other allocatees, and then grown for the next one.
+            const std::chrono::microseconds delay{(getRandomByte() * pnp_request_interval_.count()) /
                                                   std::numeric_limits<uint8_t>::max()};
-            pnp_next_request_at_ = uptime + delay;
+            pnp_next_request_at_  = uptime + delay;
+            pnp_request_interval_ = std::min<std::chrono::microseconds>(pnp_request_interval_ * 2,
+                                                                        PnPNodeIDAllocation::MaxRequestInterval);
+            // If there is no preference, the maximum value is sent.
+            const auto preferred = params_.pnp_preferred_node_id.value_or(std::numeric_limits<NodeID>::max());
             std::array<std::uint8_t, PnPNodeIDAllocation::MessageSize_v2> buf{};
             std::uint8_t*                                                 ptr = buf.data();
-            *ptr++ = std::numeric_limits<std::uint8_t>::max();
-            *ptr++ = std::numeric_limits<std::uint8_t>::max();
+            *ptr++ = static_cast<std::uint8_t>(preferred);
+            *ptr++ = static_cast<std::uint8_t>(preferred >> detail::BitsPerByte);
             (void) std::memcpy(ptr, unique_id_.data(), unique_id_.size());
             (void) publishMessageImpl(SubjectID::PnPNodeIDAllocationData_v2, pnp_transfer_id_, buf.size(), buf.data());
             ++pnp_transfer_id_;
         }
     }
 
+    /// Only the service transfers addressed to the local node and the PnP allocation responses are processed,
+    /// so the rest of the traffic on a shared link is discarded right after the header is received.
+    [[nodiscard]] auto isRelevant(const detail::Transfer::Metadata& meta) const -> bool
+    {
+        if (meta.isRequest() || meta.isResponse())
+        {
+            return local_node_id_ && (meta.destination == *local_node_id_);
+        }
+        return (!local_node_id_) && (meta.data_spec == static_cast<PortID>(SubjectID::PnPNodeIDAllocationData_v2));
+    }
+
+    /// Only service transfers addressed to the local node are considered, because the messages of the remote node
+    /// may be sent without FEC even if its service transfers are protected.
+    void updateFECPeer(const detail::Transfer::Metadata& meta)
+    {
+        if (meta.fec)
+        {
+            fec_peer_ = meta.source;
+        }
+        else if (fec_peer_ == meta.source)
+        {
+            fec_peer_.reset();
+        }
+    }
+
     void processReceivedTransfer(IReactor& reactor, const detail::Transfer& tr, const std::chrono::microseconds uptime)
     {
         if (const auto resp_id = tr.meta.isResponse())
@@ -508,6 +1408,7 @@ private:
                                    (tr.meta.transfer_id == pending_request_meta_->transfer_id);
                 if (match)
                 {
+                    updateFECPeer(tr.meta);
                     pending_request_meta_.reset();  // Reset first in case if the reactor initiates another request.
                     reactor.processResponse(tr.payload_len, tr.payload);
                 }
@@ -517,23 +1418,11 @@ private:
         {
             if (local_node_id_ && (tr.meta.destination == *local_node_id_))
             {
-                // This implementation of deduplication is grossly oversimplified. It is considered to be acceptable
-                // for this specific library because double acceptance is not expected to cause adverse effects at the
-                // application layer. The difference compared to a fully conformant implementation is that it will
-                // accept duplicate request if there was another accepted request between the duplicates:
-                //  - The normal case where duplicates removed is like: (A, A, A, B, B) --> (A, B)
-                //  - The edge case where they are not removed is like: (A, A, B, B, A) --> (A, B, A)
-                // Full-fledged implementations are obviously immune to this because they keep separate state per
-                // session specifier, which does come with certain complexity (e.g., see libserard).
-                const auto [last_meta, last_ts] = last_received_request_meta_;
-                const bool duplicate            =                                            //
-                    ((last_ts + ::kocherga::detail::DefaultTransferIDTimeout) >= uptime) &&  //
-                    (last_meta.data_spec == tr.meta.data_spec) &&                            //
-                    (last_meta.source == tr.meta.source) &&                                  //
-                    (last_meta.transfer_id == tr.meta.transfer_id);
-                if (!duplicate)
+                updateFECPeer(tr.meta);
+                // A duplicate request would cause duplicated work, such as restarting the software update,
+                // so the state is kept per session rather than for the last request only.
+                if (request_transfer_ids_.accept(tr.meta, uptime))
                 {
-                    last_received_request_meta_ = {tr.meta, uptime};
                     std::array<std::uint8_t, MaxSerializedRepresentationSize> buf{};
                     if (const auto size =
                             reactor.processRequest(*req_id, tr.meta.source, tr.payload_len, tr.payload, buf.data()))
@@ -545,9 +1434,11 @@ private:
                         meta.data_spec   = static_cast<PortID>(*req_id) |
                                          static_cast<PortID>(detail::Transfer::Metadata::DataSpecServiceFlag);
                         meta.transfer_id = tr.meta.transfer_id;
+                        meta.fec         = tr.meta.fec;
+                        const auto crc = response_crc_.update(reactor, *req_id, *size, buf.data());
                         for (auto i = 0U; i < service_multiplication_factor_; i++)
                         {
-                            (void) transmit({meta, *size, buf.data()});
+                            (void) transmit({meta, *size, buf.data()}, crc);
                         }
                     }
                 }
@@ -579,6 +1470,31 @@ private:
                                    const TransferID          transfer_id,
                                    const std::size_t         payload_length,
                                    const std::uint8_t* const payload) -> bool override
+    {
+        // The CRC is computed once for all copies of the request and kept for retransmissions.
+        request_crc_.emplace();
+        request_crc_->update(payload_length, payload);
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
+    [[nodiscard]] auto resendRequest(const ServiceID           service_id,
+                                     const NodeID              server_node_id,
+                                     const TransferID          transfer_id,
+                                     const std::size_t         payload_length,
+                                     const std::uint8_t* const payload) -> bool override
+    {
+        if (!request_crc_)
+        {
+            return sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+        }
+        return sendRequestImpl(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
+    [[nodiscard]] auto sendRequestImpl(const ServiceID           service_id,
+                                       const NodeID              server_node_id,
+                                       const TransferID          transfer_id,
+                                       const std::size_t         payload_length,
+                                       const std::uint8_t* const payload) -> bool
     {
         if (local_node_id_)
         {
@@ -589,10 +1505,11 @@ private:
                 static_cast<PortID>(service_id) | static_cast<PortID>(detail::Transfer::Metadata::DataSpecServiceFlag |
                                                                       detail::Transfer::Metadata::DataSpecRequestFlag);
             meta.transfer_id = transfer_id;
+            meta.fec         = params_.fec || (fec_peer_ == server_node_id);
             bool transmit_ok = false;  // Optimistic aggregation: one successful transmission is considered a success.
             for (auto i = 0U; i < service_multiplication_factor_; i++)
             {
-                transmit_ok = transmit({meta, payload_length, payload}) || transmit_ok;
+                transmit_ok = transmit({meta, payload_length, payload}, request_crc_) || transmit_ok;
             }
             if (transmit_ok)
             {
@@ -609,6 +1526,28 @@ private:
 
     void cancelRequest() override { pending_request_meta_.reset(); }
 
+    /// Only the PnP node-ID allocation is time-driven; the rest is driven by the incoming data.
+    /// While the TX queue is not empty, the node needs to be polled periodically to drain it.
+    /// If the last poll ran out of the RX budget, the unread data may not produce another wake-up event (e.g., with
+    /// a DMA ring buffer), so the node is to be polled again immediately.
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        if (rx_budget_exhausted_)
+        {
+            return uptime_;
+        }
+        std::optional<std::chrono::microseconds> out;
+        if (!local_node_id_)
+        {
+            out = pnp_next_request_at_;
+        }
+        if (tx_queue_.getFrameCount() > 0)
+        {
+            out = std::min(out.value_or(std::chrono::microseconds::max()), uptime_ + TxRetryInterval);
+        }
+        return out;
+    }
+
     auto publishMessage(const SubjectID           subject_id,
                         const TransferID          transfer_id,
                         const std::size_t         payload_length,
@@ -630,12 +1569,24 @@ private:
         meta.source      = local_node_id_ ? *local_node_id_ : detail::Transfer::Metadata::AnonymousNodeID;
         meta.data_spec   = static_cast<PortID>(subject_id);
         meta.transfer_id = transfer_id;
+        meta.fec         = params_.fec;
         return transmit({meta, payload_length, payload});
     }
 
-    [[nodiscard]] auto transmit(const detail::Transfer& tr) -> bool
+    /// The frame is enqueued and the queue is drained into the port immediately as far as it has space.
+    [[nodiscard]] auto transmit(const detail::Transfer& tr, const std::optional<detail::CRC32C>& payload_crc = {})
+        -> bool
     {
-        return detail::transmit([this](const std::uint8_t b) { return port_.send(b); }, tr);
+        const bool ok = tx_queue_.push(tr, payload_crc, uptime_, uptime_ + TxTimeout);
+        flush();
+        return ok;
+    }
+
+    void flush()
+    {
+        tx_queue_.flush(
+            [this](const std::uint8_t* const data, const std::size_t size) { return port_.sendBlock(data, size); },
+            uptime_);
     }
 
     struct PendingRequestMetadata
@@ -645,21 +1596,41 @@ private:
         TransferID transfer_id{};
     };
 
-    static constexpr std::size_t MaxBytesToProcessPerPoll = 1024;
+    static constexpr std::size_t MaxRequestSessions = 8;    ///< Distinct (client, service) pairs tracked.
+    static constexpr std::size_t ChunkSize          = 256;  ///< Of the data received from the port per call.
+    static constexpr std::size_t MaxTxFrames        = 16;
+
+    /// How often the node asks to be polled while the port cannot accept the pending output.
+    static constexpr std::chrono::microseconds TxRetryInterval{1'000};
+
+    static_assert(TxQueueCapacity >= detail::getMaxEncodedFrameSize(MaxSerializedRepresentationSize, true),
+                  "The TX queue shall accommodate the largest frame");
 
     const SystemInfo::UniqueID unique_id_;
+    const Params               params_;
 
-    ISerialPort&                                                     port_;
-    detail::StreamParser<MaxSerializedRepresentationSize>            stream_parser_;
-    std::optional<NodeID>                                            local_node_id_;
-    std::optional<PendingRequestMetadata>                            pending_request_meta_;
-    std::pair<detail::Transfer::Metadata, std::chrono::microseconds> last_received_request_meta_{};
+    ISerialPort&                                               port_;
+    detail::BlockStreamParser<MaxSerializedRepresentationSize> stream_parser_;
+    std::optional<NodeID>                                      local_node_id_;
+    std::optional<PendingRequestMetadata>                      pending_request_meta_;
+    std::optional<detail::CRC32C>                              request_crc_;  ///< Of the last request payload.
+    detail::ResponseCRCCache<detail::CRC32C>                   response_crc_;
+    detail::TransferIDTable<MaxRequestSessions>                request_transfer_ids_;
+    detail::TxQueue<TxQueueCapacity, MaxTxFrames>              tx_queue_;
+    std::chrono::microseconds                                  uptime_{0};  ///< As of the last poll.
+    Statistics                                                 stats_;
+    bool                                                       rx_budget_exhausted_ = false;  ///< In the last poll.
+    std::optional<NodeID>                                      fec_peer_;  ///< Last addressed us using FEC.
 
     std::chrono::microseconds pnp_next_request_at_{0};
+    std::chrono::microseconds pnp_request_interval_;
     std::uint64_t             pnp_transfer_id_ = 0;
 
     /// Controls deterministic data loss mitigation for outgoing service transfers. Messages are never duplicated.
     const std::uint8_t service_multiplication_factor_ = 1;
 };
 
+/// The default TX queue fits a few frames of the maximum size.
+using SerialNode = BasicSerialNode<2048>;
+
 }  // namespace kocherga::serial
@@ -147,6 +147,179 @@ TEST_CASE("can::TxQueue")
     REQUIRE(depth == 0);
 }
 
+TEST_CASE("can::AcceptanceFilterSet")
+{
+    using kocherga::ServiceID;
+    using kocherga::SubjectID;
+    using kocherga::can::detail::AcceptanceFilterSet;
+    using kocherga::can::detail::makeAcceptanceFilter;
+    using kocherga::can::detail::makeAcceptanceFilterSet;
+
+    const auto v1_service = [](const ServiceID sid, const bool request, const std::uint8_t dst) -> std::uint32_t {
+        return 0b100'10'0000000000'0000000'0101010UL | (static_cast<std::uint32_t>(request) << 24U) |
+               (static_cast<std::uint32_t>(sid) << 14U) | (static_cast<std::uint32_t>(dst) << 7U);
+    };
+    const auto v0_service = [](const std::uint8_t type, const bool request, const std::uint8_t dst) -> std::uint32_t {
+        return 0x1E'000080UL | (static_cast<std::uint32_t>(type) << 16U) |
+               (static_cast<std::uint32_t>(request) << 15U) | (static_cast<std::uint32_t>(dst) << 8U) | 42U;
+    };
+
+    // v1, node-ID assigned: the exact set admits only the ports we consume.
+    const std::vector<std::uint32_t> relevant_v1{
+        v1_service(ServiceID::FileRead, false, 123),
+        v1_service(ServiceID::NodeGetInfo, true, 123),
+        v1_service(ServiceID::NodeExecuteCommand, true, 123),
+    };
+    const std::vector<std::uint32_t> irrelevant_v1{
+        v1_service(ServiceID::FileRead, true, 123),         // Wrong kind
+        v1_service(ServiceID::NodeGetInfo, false, 123),     // Wrong kind
+        v1_service(ServiceID::NodeGetInfo, true, 122),      // Wrong destination
+        v1_service(static_cast<ServiceID>(384), true, 123),  // Wrong port
+        0b100'00'0011101010101'0'0101010UL,                 // Message
+    };
+    auto fs = makeAcceptanceFilterSet<1>(123);
+    REQUIRE(fs.size() == 3);
+    for (const auto id : relevant_v1)
+    {
+        REQUIRE(fs.match(id));
+        REQUIRE(makeAcceptanceFilter<1>(123).match(id));  // The coarse filter is a superset.
+    }
+    for (const auto id : irrelevant_v1)
+    {
+        REQUIRE(!fs.match(id));
+    }
+    // Reduction preserves the relevant traffic. The more filters we merge, the more irrelevant traffic gets through.
+    fs.reduce(2);
+    REQUIRE(fs.size() == 2);
+    for (const auto id : relevant_v1)
+    {
+        REQUIRE(fs.match(id));
+    }
+    REQUIRE(!fs.match(v1_service(ServiceID::NodeGetInfo, true, 122)));
+    REQUIRE(!fs.match(0b100'00'0011101010101'0'0101010UL));
+    fs.reduce(1);
+    REQUIRE(fs.size() == 1);
+    for (const auto id : relevant_v1)
+    {
+        REQUIRE(fs.match(id));
+    }
+    REQUIRE(!fs.match(v1_service(ServiceID::NodeGetInfo, true, 122)));
+    REQUIRE(fs.match(v1_service(ServiceID::NodeGetInfo, false, 123)));  // Request/response bit is lost.
+
+    // v1, anonymous: PnP responses only.
+    fs = makeAcceptanceFilterSet<1>({});
+    REQUIRE(fs.size() == 2);
+    REQUIRE(fs.match(static_cast<std::uint32_t>(SubjectID::PnPNodeIDAllocationData_v1) << 8U));
+    REQUIRE(fs.match(0b011'00'0110000000000000'01111111UL |
+                     (static_cast<std::uint32_t>(SubjectID::PnPNodeIDAllocationData_v2) << 8U)));
+    REQUIRE(!fs.match(static_cast<std::uint32_t>(SubjectID::DiagnosticRecord) << 8U));
+    REQUIRE(!fs.match(8164UL << 8U));  // Admitted by the coarse filter but not by the exact one.
+    REQUIRE(makeAcceptanceFilter<1>({}).match(8164UL << 8U));
+
+    // v0, node-ID assigned.
+    fs = makeAcceptanceFilterSet<0>(123);
+    REQUIRE(fs.size() == 3);
+    REQUIRE(fs.match(v0_service(1, true, 123)));
+    REQUIRE(fs.match(v0_service(40, true, 123)));
+    REQUIRE(fs.match(v0_service(48, false, 123)));
+    REQUIRE(!fs.match(v0_service(48, true, 123)));
+    REQUIRE(!fs.match(v0_service(1, true, 124)));
+    REQUIRE(!fs.match(v0_service(11, true, 123)));
+    REQUIRE(makeAcceptanceFilter<0>(123).match(v0_service(11, true, 123)));
+
+    // v0, anonymous: the coarse filter is already exact.
+    fs = makeAcceptanceFilterSet<0>({});
+    REQUIRE(fs.size() == 1);
+    REQUIRE(fs.data()[0] == makeAcceptanceFilter<0>({}));
+
+    // Merging is commutative and the result is a superset of both operands.
+    const kocherga::can::CANAcceptanceFilterConfig a{0b1010, 0b1111};
+    const kocherga::can::CANAcceptanceFilterConfig b{0b1001, 0b1011};
+    REQUIRE(a.merge(b) == b.merge(a));
+    REQUIRE(a.merge(b) == kocherga::can::CANAcceptanceFilterConfig{0b1000, 0b1000});
+    REQUIRE(a.merge(a) == a);
+}
+
+TEST_CASE("can::AcceptanceFilterSet early rejection benchmark")
+{
+    using kocherga::ServiceID;
+    using kocherga::can::detail::makeAcceptanceFilterSet;
+    using kocherga::can::detail::parseFrame;
+    using kocherga::can::detail::ServiceFrameModel;
+    using Clock = std::chrono::steady_clock;
+
+    // A mixed-traffic trace where most of the frames are unrelated telemetry messages published by other nodes,
+    // some are service transfers between other nodes, and only a few are addressed to the local node 123.
+    // The other nodes have node-IDs in [1, 100].
+    struct Frame
+    {
+        std::uint32_t               can_id{};
+        std::array<std::uint8_t, 8> payload{};
+    };
+    std::vector<Frame> trace;
+    std::uint32_t      rng = 0x12345678U;
+    const auto         rand = [&rng](const std::uint32_t bound) -> std::uint32_t {
+        rng = (rng * 1'103'515'245U) + 12'345U;  // Deterministic LCG so that the trace is reproducible.
+        return (rng >> 8U) % bound;
+    };
+    std::size_t relevant_count = 0;
+    for (auto i = 0U; i < 10'000U; i++)
+    {
+        Frame      fr{};
+        const auto kind = rand(100);
+        if (kind < 95U)  // Message
+        {
+            fr.can_id = (rand(8) << 26U) | (3U << 21U) | (rand(8192) << 8U) | (rand(100) + 1U);
+        }
+        else if (kind < 99U)  // Service transfer between other nodes
+        {
+            fr.can_id = (rand(8) << 26U) | (1U << 25U) | (rand(2) << 24U) | (rand(512) << 14U) |
+                        ((rand(100) + 1U) << 7U) | (rand(100) + 1U);
+        }
+        else  // GetInfo request to the local node
+        {
+            fr.can_id = (rand(8) << 26U) | (3U << 24U) | (static_cast<std::uint32_t>(ServiceID::NodeGetInfo) << 14U) |
+                        (123U << 7U) | (rand(100) + 1U);
+            relevant_count++;
+        }
+        fr.payload.back() = static_cast<std::uint8_t>(0b1110'0000U | rand(32));
+        trace.push_back(fr);
+    }
+
+    static constexpr std::size_t Repetitions = 100;
+    const auto                   fs          = makeAcceptanceFilterSet<1>(123);
+    // Returns the number of frames addressed to the local node and the time it took to find them.
+    const auto run = [&trace, &fs](const bool classify) -> std::pair<std::size_t, Clock::duration> {
+        std::size_t out     = 0;
+        const auto  started = Clock::now();
+        for (auto rep = 0U; rep < Repetitions; rep++)
+        {
+            for (const auto& fr : trace)
+            {
+                if ((!classify) || fs.match(fr.can_id))
+                {
+                    if (const auto f = parseFrame(fr.can_id, fr.payload.size(), fr.payload.data()))
+                    {
+                        const auto* const s = std::get_if<ServiceFrameModel>(&*f);
+                        out += ((s != nullptr) && (s->destination_node_id == 123U)) ? 1U : 0U;
+                    }
+                }
+            }
+        }
+        return {out, Clock::now() - started};
+    };
+    const auto [parsed_count, parsed_time]         = run(false);
+    const auto [classified_count, classified_time] = run(true);
+    REQUIRE(parsed_count == (relevant_count * Repetitions));
+    REQUIRE(classified_count == parsed_count);
+    const auto ns_per_frame = [&trace](const Clock::duration d) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+               static_cast<double>(trace.size() * Repetitions);
+    };
+    std::cout << "Full parsing: " << ns_per_frame(parsed_time) << " ns/frame; "
+              << "early rejection: " << ns_per_frame(classified_time) << " ns/frame" << std::endl;
+}
+
 TEST_CASE("can::parseFrame")
 {
     using kocherga::can::detail::parseFrame;
@@ -487,6 +660,40 @@ TEST_CASE("can::BasicTransferReasm")
         REQUIRE(check_result(rs.update(mk_srv(123, 9, false, 9, {false, true, false}, {6, 40, 194})),
                              {0, 1, 2, 3, 4, 5, 6}));
     }
+
+    // Interleaved transfers from multiple sources.
+    {
+        BasicServiceTransferReasm<16, 2> rs(9);
+        REQUIRE(!rs.update(mk_srv(123, 9, true, 3, {true, false, true}, {0, 1, 2, 3, 4, 5, 6})));
+        REQUIRE(!rs.update(mk_srv(124, 9, true, 7, {true, false, true}, {0, 1, 2, 3, 4, 5})));
+        REQUIRE(check_result(rs.update(mk_srv(124, 9, true, 7, {false, true, false}, {6, 40, 194})),
+                             {0, 1, 2, 3, 4, 5, 6}));
+        REQUIRE(check_result(rs.update(mk_srv(123, 9, true, 3, {false, true, false}, {7, 8, 9, 194, 65})),
+                             {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+        // Each session remembers its own transfer-ID, so duplicates are still detected.
+        REQUIRE(!rs.update(mk_srv(124, 9, true, 7, {true, true, true}, {1})));
+        // The table is full; 123 is the least recently used session, so it is evicted and its history is lost.
+        REQUIRE(check_result(rs.update(mk_srv(125, 9, true, 7, {true, true, true}, {1})), {1}));
+        REQUIRE(!rs.update(mk_srv(124, 9, true, 7, {true, true, true}, {1})));
+        REQUIRE(check_result(rs.update(mk_srv(123, 9, true, 3, {true, true, true}, {2})), {2}));
+        // Now 125 has been evicted. A continuation frame from an unknown source is ignored.
+        REQUIRE(!rs.update(mk_srv(125, 9, true, 8, {false, true, false}, {7, 8, 9, 194, 65})));
+    }
+
+    // Reassembly into an external sink; the capacity of the sink replaces the extent.
+    {
+        BasicServiceTransferReasm<0>                rs(9);
+        std::array<std::uint8_t, 8>                 sink{};
+        const std::pair<std::size_t, std::uint8_t*> sink_ref{sink.size(), sink.data()};
+        REQUIRE(!rs.update(mk_srv(123, 9, false, 3, {true, false, true}, {0, 1, 2, 3, 4, 5, 6}), sink_ref));
+        const auto res = rs.update(mk_srv(123, 9, false, 3, {false, true, false}, {7, 8, 9, 194, 65}), sink_ref);
+        REQUIRE(check_result(res, {0, 1, 2, 3, 4, 5, 6, 7}));  // Implicit truncation.
+        REQUIRE(res->second == sink.data());
+        // Without the sink, the internal storage is used, which is empty.
+        const auto empty = rs.update(mk_srv(123, 9, false, 4, {true, true, true}, {0, 1, 2}));
+        REQUIRE(empty);
+        REQUIRE(empty->first == 0);
+    }
 }
 
 TEST_CASE("can::BasicTransferReasmV0")
@@ -596,6 +803,75 @@ TEST_CASE("can::BasicTransferReasmV0")
         REQUIRE(!rs.update(srv(123, 9, false, 9, {false, false, true}, {0x62, 0x61, 0x78, 0x2E, 0x74, 0x65, 0x6C})));
         REQUIRE(check_result(rs.update(srv(123, 9, false, 9, {false, true, false}, {0x65, 0x67, 0x61})), ref));
     }
+    // Interleaved transfers from multiple sources.
+    {
+        BasicServiceTransferReasmV0<100, 2> rs(0xEE468A8121C46A9EULL, 9);
+        const std::vector<Buf> frames{
+            {0xAC, 0x11, 0x04, 0x00, 0x00, 0x00, 0xD0},
+            {0xC1, 0xFE, 0x00, 0x04, 0x03, 0x6E, 0xFF},
+            {0x55, 0x8E, 0x0D, 0xCE, 0x43, 0x9D, 0x90},
+            {0x5E, 0xD9, 0xF4, 0x01, 0x02, 0x3C, 0x00},
+            {0x1E, 0x00, 0x0D, 0x50, 0x53, 0x37, 0x54},
+            {0x31, 0x37, 0x20, 0x00, 0x00, 0x00, 0x00},
+            {0x00, 0x63, 0x6F, 0x6D, 0x2E, 0x7A, 0x75},
+            {0x62, 0x61, 0x78, 0x2E, 0x74, 0x65, 0x6C},
+        };
+        bool toggle = false;
+        for (std::size_t i = 0; i < frames.size(); i++)
+        {
+            REQUIRE(!rs.update(srv(123, 9, false, 9, {i == 0, false, toggle}, frames.at(i))));
+            REQUIRE(!rs.update(srv(124, 9, false, 2, {i == 0, false, toggle}, frames.at(i))));
+            toggle = !toggle;
+        }
+        const Buf ref{0x04, 0x00, 0x00, 0x00, 0xD0, 0xC1, 0xFE, 0x00, 0x04, 0x03, 0x6E, 0xFF, 0x55, 0x8E, 0x0D,
+                      0xCE, 0x43, 0x9D, 0x90, 0x5E, 0xD9, 0xF4, 0x01, 0x02, 0x3C, 0x00, 0x1E, 0x00, 0x0D, 0x50,
+                      0x53, 0x37, 0x54, 0x31, 0x37, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x63, 0x6F, 0x6D, 0x2E,
+                      0x7A, 0x75, 0x62, 0x61, 0x78, 0x2E, 0x74, 0x65, 0x6C, 0x65, 0x67, 0x61};
+        REQUIRE(check_result(rs.update(srv(124, 9, false, 2, {false, true, toggle}, {0x65, 0x67, 0x61})), ref));
+        REQUIRE(check_result(rs.update(srv(123, 9, false, 9, {false, true, toggle}, {0x65, 0x67, 0x61})), ref));
+        // A third source evicts the least recently used session (124), but not the other one.
+        REQUIRE(check_result(rs.update(srv(125, 9, true, 5, {true, true, false}, {1, 2, 3})), {1, 2, 3}));
+        REQUIRE(!rs.update(srv(123, 9, false, 9, {true, true, false}, {1, 2, 3})));
+        REQUIRE(check_result(rs.update(srv(124, 9, false, 2, {true, true, false}, {1, 2, 3})), {1, 2, 3}));
+    }
+    // Reassembly into an external sink; the transfer CRC is not stored.
+    {
+        BasicServiceTransferReasmV0<0>              rs(0xEE468A8121C46A9EULL, 9);
+        std::array<std::uint8_t, 60>                sink{};
+        const std::pair<std::size_t, std::uint8_t*> sink_ref{sink.size(), sink.data()};
+        const std::vector<Buf>                      frames{
+            {0xAC, 0x11, 0x04, 0x00, 0x00, 0x00, 0xD0},
+            {0xC1, 0xFE, 0x00, 0x04, 0x03, 0x6E, 0xFF},
+            {0x55, 0x8E, 0x0D, 0xCE, 0x43, 0x9D, 0x90},
+            {0x5E, 0xD9, 0xF4, 0x01, 0x02, 0x3C, 0x00},
+            {0x1E, 0x00, 0x0D, 0x50, 0x53, 0x37, 0x54},
+            {0x31, 0x37, 0x20, 0x00, 0x00, 0x00, 0x00},
+            {0x00, 0x63, 0x6F, 0x6D, 0x2E, 0x7A, 0x75},
+            {0x62, 0x61, 0x78, 0x2E, 0x74, 0x65, 0x6C},
+        };
+        const Buf ref{0x04, 0x00, 0x00, 0x00, 0xD0, 0xC1, 0xFE, 0x00, 0x04, 0x03, 0x6E, 0xFF, 0x55, 0x8E, 0x0D,
+                      0xCE, 0x43, 0x9D, 0x90, 0x5E, 0xD9, 0xF4, 0x01, 0x02, 0x3C, 0x00, 0x1E, 0x00, 0x0D, 0x50,
+                      0x53, 0x37, 0x54, 0x31, 0x37, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x63, 0x6F, 0x6D, 0x2E,
+                      0x7A, 0x75, 0x62, 0x61, 0x78, 0x2E, 0x74, 0x65, 0x6C, 0x65, 0x67, 0x61};
+        bool toggle = false;
+        for (std::size_t i = 0; i < frames.size(); i++)
+        {
+            REQUIRE(!rs.update(srv(123, 9, false, 9, {i == 0, false, toggle}, frames.at(i)), sink_ref));
+            toggle = !toggle;
+        }
+        const auto res = rs.update(srv(123, 9, false, 9, {false, true, toggle}, {0x65, 0x67, 0x61}), sink_ref);
+        REQUIRE(check_result(res, ref));
+        REQUIRE(res->second == sink.data());
+        // Same but the sink is too small; DroneCAN does not support implicit truncation.
+        const std::pair<std::size_t, std::uint8_t*> small_sink_ref{ref.size() - 1U, sink.data()};
+        toggle = false;
+        for (std::size_t i = 0; i < frames.size(); i++)
+        {
+            REQUIRE(!rs.update(srv(123, 9, false, 10, {i == 0, false, toggle}, frames.at(i)), small_sink_ref));
+            toggle = !toggle;
+        }
+        REQUIRE(!rs.update(srv(123, 9, false, 10, {false, true, toggle}, {0x65, 0x67, 0x61}), small_sink_ref));
+    }
 }
 
 TEST_CASE("can::transmit")
@@ -695,6 +971,58 @@ TEST_CASE("can::transmit")
     }
 }
 
+TEST_CASE("can::planTransportLayerMTU")
+{
+    using kocherga::can::ICANDriver;
+    using kocherga::can::detail::estimateTransferDuration;
+    using kocherga::can::detail::planTransportLayerMTU;
+    using kocherga::can::detail::transmit;
+    const std::vector<std::uint8_t> dummy(1024);
+    // Reference model: compute the cost from the frames actually emitted by transmit().
+    const auto measure = [&dummy](const ICANDriver::Bitrate& br, const std::size_t mtu, const std::size_t size) {
+        std::uint64_t out  = 0;
+        const auto    push = [&out, &br](const std::size_t frame_size, const std::uint8_t* const) -> bool {
+            const std::size_t   len       = ICANDriver::DLCToLength.at(ICANDriver::LengthToDLC.at(frame_size));
+            const std::uint64_t data_bits = ((len > 16) ? 30U : 26U) + (len * 8U);
+            out += (49U * br.data) + (data_bits * br.arbitration);
+            return true;
+        };
+        REQUIRE(transmit(push, mtu, 0, size, dummy.data()));
+        return out;
+    };
+    const std::array<ICANDriver::Bitrate, 3> bitrates{{
+        {1'000'000, 1'000'000},
+        {1'000'000, 4'000'000},
+        {500'000, 2'000'000},
+    }};
+    for (const auto& br : bitrates)
+    {
+        for (std::size_t size = 0; size < 300; size++)
+        {
+            std::uint64_t min_cost = std::numeric_limits<std::uint64_t>::max();
+            for (const std::size_t mtu : {8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U})
+            {
+                const auto cost = estimateTransferDuration(br, mtu, size);
+                REQUIRE(cost == measure(br, mtu, size));
+                min_cost = std::min(min_cost, cost);
+            }
+            const auto best = planTransportLayerMTU(br, 64, size);
+            REQUIRE(estimateTransferDuration(br, best, size) == min_cost);
+            REQUIRE(planTransportLayerMTU(br, 32, size) <= 32);
+            REQUIRE(planTransportLayerMTU(br, 8, size) == 8);
+            REQUIRE(planTransportLayerMTU(br, 0, size) == 8);
+            REQUIRE(planTransportLayerMTU(br, 63, size) <= 48);
+        }
+    }
+    // Without BRS, 32+5 bytes are cheaper than 48 bytes with padding.
+    REQUIRE(32 == planTransportLayerMTU({1'000'000, 1'000'000}, 64, 33));
+    // With BRS, the arbitration phase dominates, so the largest frames win.
+    REQUIRE(64 == planTransportLayerMTU({1'000'000, 4'000'000}, 64, 33));
+    REQUIRE(64 == planTransportLayerMTU({1'000'000, 4'000'000}, 64, 256));
+    // Short transfers fit into a single frame regardless of the MTU; ties resolve to larger frames.
+    REQUIRE(64 == planTransportLayerMTU({1'000'000, 1'000'000}, 64, 5));
+}
+
 TEST_CASE("can::transmitV0")
 {
     using kocherga::can::detail::transmitV0;
@@ -756,6 +1084,56 @@ TEST_CASE("can::transmitV0")
     }
 }
 
+TEST_CASE("can::transmit precomputed CRC")
+{
+    using kocherga::can::detail::computeTransferCRCV0;
+    using kocherga::can::detail::transmit;
+    using kocherga::can::detail::transmitV0;
+    using kocherga::detail::CRC16CCITT;
+    using Buf      = std::vector<std::uint8_t>;
+    using MultiBuf = std::vector<Buf>;
+
+    std::vector<std::uint8_t> payload(300);
+    std::iota(payload.begin(), payload.end(), 0U);
+    MultiBuf   frames;
+    const auto push = [&frames](const std::size_t size, const std::uint8_t* const data) -> bool {
+        frames.emplace_back(data, data + size);
+        return true;
+    };
+    for (std::size_t size = 0; size < payload.size(); size++)
+    {
+        CRC16CCITT crc;
+        crc.update(size, payload.data());
+        for (const std::size_t mtu : {8U, 16U, 32U, 64U})
+        {
+            frames.clear();
+            REQUIRE(transmit(push, mtu, 7, size, payload.data()));
+            const auto reference = frames;
+            frames.clear();
+            REQUIRE(transmit(push, mtu, 7, size, payload.data(), crc));
+            REQUIRE(frames == reference);
+        }
+        frames.clear();
+        REQUIRE(transmitV0(push, 0x0123'4567'89AB'CDEFULL, 9, size, payload.data()));
+        const auto reference = frames;
+        frames.clear();
+        REQUIRE(transmitV0(push,
+                           0x0123'4567'89AB'CDEFULL,
+                           9,
+                           size,
+                           payload.data(),
+                           computeTransferCRCV0(0x0123'4567'89AB'CDEFULL, size, payload.data())));
+        REQUIRE(frames == reference);
+    }
+    // The supplied CRC is used as-is without looking at the payload.
+    frames.clear();
+    REQUIRE(transmit(push, 8, 3, 10, payload.data(), CRC16CCITT{}));
+    REQUIRE(frames == MultiBuf{
+                          Buf{0, 1, 2, 3, 4, 5, 6, 0b1010'0011},
+                          Buf{7, 8, 9, 0xFF, 0xFF, 0b0100'0011},
+                      });
+}
+
 TEST_CASE("CAN transfer roundtrip")
 {
     using kocherga::can::detail::MessageFrameModel;
@@ -13,7 +13,7 @@ namespace
 {
 using Bitrate = kocherga::can::ICANDriver::Bitrate;
 using kocherga::can::CANAcceptanceFilterConfig;
-using Allocator = kocherga::can::detail::BlockAllocator<1024, 2>;
+using Allocator = kocherga::can::detail::BlockAllocator<kocherga::can::detail::MaxActivitySize, 2>;
 
 class CANDriverMock : public kocherga::can::ICANDriver
 {
@@ -23,6 +23,8 @@ public:
         Bitrate                   bitrate{};
         bool                      silent{};
         CANAcceptanceFilterConfig filter{};
+
+        std::vector<CANAcceptanceFilterConfig> filters;  ///< Populated only if configureMulti() was used.
     };
 
     struct Frame
@@ -38,6 +40,10 @@ public:
 
     void setMode(const std::optional<Mode> m) { mode_ = m; }
 
+    void setMaxAcceptanceFilters(const std::size_t value) { max_filters_ = value; }
+
+    void setMaxFDPayloadSize(const std::size_t value) { max_fd_payload_size_ = value; }
+
     [[nodiscard]] auto getConfig() const -> std::optional<Config> { return config_; }
 
     [[nodiscard]] auto popTx() -> std::optional<TxFrame>
@@ -56,7 +62,22 @@ public:
     [[nodiscard]] auto configure(const Bitrate& bitrate, const bool silent, const CANAcceptanceFilterConfig& filter)
         -> std::optional<Mode> override
     {
-        config_ = {bitrate, silent, filter};
+        config_ = {bitrate, silent, filter, {}};
+        return mode_;
+    }
+
+    [[nodiscard]] auto getMaxAcceptanceFilters() const -> std::size_t override { return max_filters_; }
+
+    [[nodiscard]] auto getMaxFDPayloadSize() const -> std::size_t override { return max_fd_payload_size_; }
+
+    [[nodiscard]] auto configureMulti(const Bitrate&                         bitrate,
+                                      const bool                             silent,
+                                      const std::size_t                      num_filters,
+                                      const CANAcceptanceFilterConfig* const filters) -> std::optional<Mode> override
+    {
+        REQUIRE(num_filters > 0);
+        REQUIRE(num_filters <= max_filters_);
+        config_ = {bitrate, silent, {}, {filters, filters + num_filters}};
         return mode_;
     }
 
@@ -93,11 +114,96 @@ private:
     }
 
     std::optional<Mode>   mode_;
+    std::size_t           max_filters_         = 1;
+    std::size_t           max_fd_payload_size_ = 64;
     std::optional<Config> config_;
     std::deque<TxFrame>   tx_;
     std::deque<Frame>     rx_;
 };
 
+/// Models a bus where the other nodes emit a frame periodically at the specified bit rate.
+/// If the local controller is configured with a different bit rate, each frame results in a protocol error instead.
+class SimulatedBusDriver : public kocherga::can::ICANDriver
+{
+public:
+    SimulatedBusDriver(const Bitrate                   bus_bitrate,
+                       const std::chrono::microseconds frame_period,
+                       const bool                      report_errors) :
+        bus_bitrate_(bus_bitrate), frame_period_(frame_period), report_errors_(report_errors)
+    {}
+
+    void setUptime(const std::chrono::microseconds uptime) { uptime_ = uptime; }
+
+private:
+    [[nodiscard]] auto configure(const Bitrate& bitrate, const bool silent, const CANAcceptanceFilterConfig& filter)
+        -> std::optional<Mode> override
+    {
+        (void) silent;
+        (void) filter;
+        bitrate_ = bitrate;
+        errors_  = 0;
+        return Mode::FD;
+    }
+
+    [[nodiscard]] auto getProtocolErrorCount() -> std::optional<std::uint32_t> override
+    {
+        advance();
+        return report_errors_ ? std::optional<std::uint32_t>(errors_) : std::optional<std::uint32_t>{};
+    }
+
+    [[nodiscard]] auto push(const bool          force_classic_can,
+                            const std::uint32_t extended_can_id,
+                            const std::uint8_t  payload_size,
+                            const void* const   payload) -> bool override
+    {
+        (void) force_classic_can;
+        (void) extended_can_id;
+        (void) payload_size;
+        (void) payload;
+        return true;
+    }
+
+    [[nodiscard]] auto pop(PayloadBuffer& payload_buffer)
+        -> std::optional<std::pair<std::uint32_t, std::uint8_t>> override
+    {
+        advance();
+        if (pending_ > 0)
+        {
+            pending_--;
+            payload_buffer.at(0) = 0b1110'0000U;
+            return {{0x10'7D'55'2AUL, 1}};
+        }
+        const std::optional<std::pair<std::uint32_t, std::uint8_t>> empty{};  // Suppress bogus warning from GCC.
+        return empty;
+    }
+
+    void advance()
+    {
+        while (uptime_ >= next_frame_at_)
+        {
+            next_frame_at_ += frame_period_;
+            if (bitrate_ && (*bitrate_ == bus_bitrate_))
+            {
+                pending_++;
+            }
+            else if (bitrate_)
+            {
+                errors_++;
+            }
+        }
+    }
+
+    const Bitrate                   bus_bitrate_;
+    const std::chrono::microseconds frame_period_;
+    const bool                      report_errors_;
+
+    std::chrono::microseconds next_frame_at_{};
+    std::chrono::microseconds uptime_{};
+    std::optional<Bitrate>    bitrate_;
+    std::uint32_t             errors_  = 0;
+    std::size_t               pending_ = 0;
+};
+
 class ReactorMock : public kocherga::IReactor
 {
 public:
@@ -146,12 +252,19 @@ private:
 
     void processResponse(const std::size_t response_length, const std::uint8_t* const response) override
     {
+        REQUIRE(response == response_buffer_.data());  // The response shall be reassembled in place.
         pending_responses_.emplace_back();
         std::copy_n(response, response_length, std::back_insert_iterator(pending_responses_.back()));
     }
 
-    IncomingRequestHandler                request_handler_;
-    std::deque<std::vector<std::uint8_t>> pending_responses_;
+    [[nodiscard]] auto getResponseBuffer() -> std::pair<std::size_t, std::uint8_t*> override
+    {
+        return {response_buffer_.size(), response_buffer_.data()};
+    }
+
+    IncomingRequestHandler                                                       request_handler_;
+    std::deque<std::vector<std::uint8_t>>                                        pending_responses_;
+    std::array<std::uint8_t, kocherga::detail::dsdl::File::ReadResponseSizeMax> response_buffer_{};
 };
 
 }  // namespace
@@ -170,7 +283,9 @@ TEST_CASE("can::detail::BitrateDetectionActivity")
 
     act = std::make_shared<BitrateDetectionActivity>(alloc, driver, kocherga::SystemInfo::UniqueID{});
     REQUIRE(!driver.getConfig());
+    REQUIRE(act->getNextDeadline() == std::chrono::microseconds(0));  // Not configured yet, poll immediately.
     REQUIRE(!act->poll(reactor, std::chrono::microseconds(1'000)));
+    REQUIRE(act->getNextDeadline() == std::chrono::microseconds(1'101'001));
     REQUIRE(driver.getConfig()->bitrate == Bitrate{1'000'000, 4'000'000});
     REQUIRE(driver.getConfig()->silent);
     REQUIRE(driver.getConfig()->filter == CANAcceptanceFilterConfig{0x1FFFFFFF, 0});
@@ -189,6 +304,103 @@ TEST_CASE("can::detail::BitrateDetectionActivity")
     REQUIRE(driver.getConfig()->silent);
     REQUIRE(driver.getConfig()->filter == CANAcceptanceFilterConfig{0x1FFFFFFF, 0});
     REQUIRE(dynamic_cast<VersionDetectionActivity*>(proto_ver_act));
+
+    // The preferred bit rate is tried first, the standard bit rates follow without repetition.
+    act = std::make_shared<BitrateDetectionActivity>(alloc,
+                                                     driver,
+                                                     kocherga::SystemInfo::UniqueID{},
+                                                     Bitrate{250'000, 1'000'000});
+    REQUIRE(!act->poll(reactor, std::chrono::microseconds(1'000)));
+    REQUIRE(driver.getConfig()->bitrate == Bitrate{250'000, 1'000'000});
+    REQUIRE(!act->poll(reactor, std::chrono::microseconds(1'200'000)));
+    REQUIRE(driver.getConfig()->bitrate == Bitrate{1'000'000, 4'000'000});
+    REQUIRE(!act->poll(reactor, std::chrono::microseconds(2'400'000)));
+    REQUIRE(driver.getConfig()->bitrate == Bitrate{500'000, 2'000'000});
+    REQUIRE(!act->poll(reactor, std::chrono::microseconds(3'600'000)));
+    REQUIRE(driver.getConfig()->bitrate == Bitrate{125'000, 500'000});
+    REQUIRE(!act->poll(reactor, std::chrono::microseconds(4'800'000)));
+    REQUIRE(driver.getConfig()->bitrate == Bitrate{250'000, 1'000'000});  // Loop over!
+}
+
+TEST_CASE("can::detail::BitrateDetectionActivity error feedback")
+{
+    using kocherga::can::detail::IActivity;
+    using kocherga::can::detail::BitrateDetectionActivity;
+    using kocherga::can::detail::VersionDetectionActivity;
+    using kocherga::can::ICANDriver;
+    using std::chrono::microseconds;
+    ReactorMock reactor;
+
+    // Returns the time it took to detect the bit rate of the bus.
+    const auto measure = [&reactor](const Bitrate                 bus_bitrate,
+                                    const bool                    report_errors,
+                                    const std::optional<Bitrate>& preferred_bitrate) -> microseconds {
+        Allocator                alloc;
+        SimulatedBusDriver       driver(bus_bitrate, microseconds(10'000), report_errors);
+        BitrateDetectionActivity act(alloc, driver, kocherga::SystemInfo::UniqueID{}, preferred_bitrate);
+        const microseconds       started_at(1'000);
+        for (microseconds uptime = started_at; uptime < microseconds(20'000'000); uptime += microseconds(1'000))
+        {
+            driver.setUptime(uptime);
+            if (IActivity* const next = static_cast<IActivity&>(act).poll(reactor, uptime))
+            {
+                REQUIRE(dynamic_cast<VersionDetectionActivity*>(next));
+                return uptime - started_at;
+            }
+        }
+        FAIL("Bit rate not detected");
+        return {};
+    };
+
+    microseconds worst_with_errors{};
+    microseconds worst_without_errors{};
+    for (const auto& br : ICANDriver::StandardBitrates)
+    {
+        const auto with_errors    = measure(br, true, {});
+        const auto without_errors = measure(br, false, {});
+        const auto preferred      = measure(br, true, br);
+        std::cout << "Bit rate " << br.arbitration << ": detected in " << with_errors.count() << " us with errors, "
+                  << without_errors.count() << " us without errors, " << preferred.count() << " us if preferred"
+                  << std::endl;
+        REQUIRE(with_errors <= without_errors);
+        REQUIRE(preferred <= microseconds(20'000));
+        worst_with_errors    = std::max(worst_with_errors, with_errors);
+        worst_without_errors = std::max(worst_without_errors, without_errors);
+    }
+    // Each wrong bit rate is rejected after a few frames rather than after the full listening period.
+    REQUIRE(worst_with_errors <= microseconds(200'000));
+    REQUIRE(worst_without_errors >= microseconds(3'000'000));
+}
+
+TEST_CASE("can::detail::BitrateDetectionActivity tickless")
+{
+    using kocherga::can::detail::IActivity;
+    using kocherga::can::detail::BitrateDetectionActivity;
+    using kocherga::can::detail::VersionDetectionActivity;
+    using kocherga::can::ICANDriver;
+    using std::chrono::microseconds;
+    ReactorMock reactor;
+
+    // The activity is polled only at the deadlines it reports, as a host sleeping between them would do.
+    // A wrong bit rate produces no traffic to wake up the host, so the error feedback relies on the deadlines alone.
+    for (const auto& br : ICANDriver::StandardBitrates)
+    {
+        Allocator                alloc;
+        SimulatedBusDriver       driver(br, microseconds(10'000), true);
+        BitrateDetectionActivity act(alloc, driver, kocherga::SystemInfo::UniqueID{});
+        auto&                    iact = static_cast<IActivity&>(act);
+        microseconds             uptime(1'000);
+        IActivity*               next = nullptr;
+        for (std::size_t i = 0; (i < 10'000) && (next == nullptr) && (uptime < microseconds(20'000'000)); i++)
+        {
+            driver.setUptime(uptime);
+            next = iact.poll(reactor, uptime);
+            REQUIRE(iact.getNextDeadline());
+            uptime = std::max(uptime, *iact.getNextDeadline());
+        }
+        REQUIRE(dynamic_cast<VersionDetectionActivity*>(next));
+        REQUIRE(uptime <= microseconds(200'000));  // Not the full listening period per wrong bit rate.
+    }
 }
 
 TEST_CASE("can::detail::VersionDetectionActivity")
@@ -239,8 +451,10 @@ TEST_CASE("can::detail::VersionDetectionActivity")
         act = std::make_shared<VersionDetectionActivity>(alloc, driver, kocherga::SystemInfo::UniqueID{}, br);
         REQUIRE(!act->poll(reactor, std::chrono::microseconds(1'000)));
         REQUIRE(!act->poll(reactor, std::chrono::microseconds(1'000'000)));
+        REQUIRE(!act->getNextDeadline());  // Nothing to do until the traffic is observed.
         driver.pushRx(CANDriverMock::Frame{123456, {0, 1, 2, 3, 0b1000'0000}});  // DroneCAN
         REQUIRE(!act->poll(reactor, std::chrono::microseconds(2'000'000)));
+        REQUIRE(act->getNextDeadline() == std::chrono::microseconds(3'100'001));
         IActivity* const v0_pnp_act = act->poll(reactor, std::chrono::microseconds(4'000'000));
         REQUIRE(v0_pnp_act);
         REQUIRE(dynamic_cast<V0NodeIDAllocationActivity*>(v0_pnp_act));
@@ -1174,3 +1388,492 @@ TEST_CASE("can::CANNode v0")
     REQUIRE(!static_cast<kocherga::INode&>(node).sendRequest(ServiceID::NodeExecuteCommand, 124, 22, 0, nullptr));
     REQUIRE(!poll(1000us));
 }
+
+TEST_CASE("can::CANNode multiple acceptance filters")
+{
+    using kocherga::can::CANNode;
+    using kocherga::can::detail::makeAcceptanceFilter;
+    using kocherga::can::detail::makeAcceptanceFilterSet;
+
+    const Bitrate                        br{1'000'000, 4'000'000};
+    const kocherga::SystemInfo::UniqueID uid{};
+
+    // The driver does not support multiple filters; the legacy single filter is used.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        const CANNode node(driver, uid, br, 1, 123);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>(123));
+        REQUIRE(driver.getConfig()->filters.empty());
+        REQUIRE(!driver.getConfig()->silent);
+    }
+    // Enough filter banks for the exact set.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        driver.setMaxAcceptanceFilters(8);
+        const CANNode node(driver, uid, br, 1, 123);
+        const auto    ref = makeAcceptanceFilterSet<1>(123);
+        REQUIRE(driver.getConfig()->filters == std::vector<CANAcceptanceFilterConfig>(ref.data(), ref.data() + 3));
+        REQUIRE(!driver.getConfig()->silent);
+    }
+    // Not enough filter banks, some filters are merged.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::Classic);
+        driver.setMaxAcceptanceFilters(2);
+        const CANNode node(driver, uid, br, 0, 123);
+        REQUIRE(driver.getConfig()->filters.size() == 2);
+    }
+    // PnP.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        driver.setMaxAcceptanceFilters(2);
+        const CANNode node(driver, uid, br, 1);
+        const auto    ref = makeAcceptanceFilterSet<1>({});
+        REQUIRE(driver.getConfig()->filters == std::vector<CANAcceptanceFilterConfig>(ref.data(), ref.data() + 2));
+    }
+}
+
+TEST_CASE("can::CANNode warm start")
+{
+    using kocherga::can::CANNode;
+    using kocherga::can::CANNetworkProfile;
+    using kocherga::can::detail::makeAcceptanceFilter;
+    using std::chrono_literals::operator""us;
+
+    ReactorMock                          reactor;
+    const Bitrate                        br{250'000, 1'000'000};
+    const kocherga::SystemInfo::UniqueID uid{};
+
+    const CANDriverMock::Frame heartbeat_v1{
+        0x10'7D'55'2AUL,  // Heartbeat from node 42
+        {0, 0, 0, 0, 0, 0, 0, 0b1110'0000U},
+    };
+    const CANDriverMock::Frame heartbeat_v1_conflict{
+        0x10'7D'55'7BUL,  // Heartbeat from node 123
+        {0, 0, 0, 0, 0, 0, 0, 0b1110'0000U},
+    };
+    const CANDriverMock::Frame node_status_v0{
+        0x10'01'55'2AUL,  // NodeStatus from node 42
+        {0, 0, 0, 0, 0, 0, 0, 0b1100'0000U},
+    };
+    const auto poll = [&reactor](CANNode& node, const std::chrono::microseconds uptime) {
+        static_cast<kocherga::INode&>(node).poll(reactor, uptime);
+    };
+
+    // The profile is confirmed by the traffic, the node goes online once the validation period has expired.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 1, 123});
+        REQUIRE(driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        REQUIRE(driver.getConfig()->filter == CANAcceptanceFilterConfig::makePromiscuous());
+        REQUIRE(!node.getNetworkProfile());
+        poll(node, 1'000us);
+        REQUIRE(!node.getNetworkProfile());
+        driver.pushRx(node_status_v0);  // Lower version is not a contradiction, keep waiting.
+        poll(node, 2'000us);
+        REQUIRE(!node.getNetworkProfile());
+        driver.pushRx(heartbeat_v1);
+        poll(node, 3'000us);
+        REQUIRE(driver.getConfig()->silent);  // The version is confirmed but a conflict may still show up.
+        REQUIRE(!node.getNetworkProfile());
+        poll(node, 1'100'000us);
+        REQUIRE(driver.getConfig()->silent);
+        poll(node, 1'101'000us);
+        REQUIRE(!driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>(123));
+        REQUIRE(node.getNetworkProfile() == CANNetworkProfile{br, 1, 123});
+    }
+    // Same with v0.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::Classic);
+        CANNode node(driver, uid, CANNetworkProfile{br, 0, 123});
+        driver.pushRx(node_status_v0);
+        poll(node, 1'000us);
+        REQUIRE(driver.getConfig()->silent);
+        poll(node, 1'101'000us);
+        REQUIRE(!driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<0>(123));
+        REQUIRE(node.getNetworkProfile() == CANNetworkProfile{br, 0, 123});
+    }
+    // The node-ID is taken by another node, a new one has to be allocated.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 1, 123});
+        driver.pushRx(heartbeat_v1_conflict);
+        poll(node, 1'000us);
+        REQUIRE(!driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>({}));
+        REQUIRE(!node.getNetworkProfile());
+    }
+    // The conflicting node is not the first one to speak; the conflict is still detected before going online.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 1, 123});
+        driver.pushRx(heartbeat_v1);
+        poll(node, 1'000us);
+        REQUIRE(driver.getConfig()->silent);
+        driver.pushRx(heartbeat_v1);
+        poll(node, 500'000us);
+        REQUIRE(driver.getConfig()->silent);
+        driver.pushRx(heartbeat_v1_conflict);
+        poll(node, 900'000us);
+        REQUIRE(!driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>({}));
+        poll(node, 2'000'000us);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>({}));
+        REQUIRE(!node.getNetworkProfile());
+    }
+    // The protocol version has changed; the bit rate is still valid so only the version detection is repeated.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 0, 123});
+        driver.pushRx(heartbeat_v1);
+        poll(node, 1'000us);
+        REQUIRE(driver.getConfig()->silent);
+        driver.pushRx(heartbeat_v1);
+        poll(node, 2'000us);
+        REQUIRE(driver.getConfig()->silent);
+        poll(node, 2'000'000us);  // Version detection completed.
+        REQUIRE(!driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        REQUIRE(driver.getConfig()->filter == makeAcceptanceFilter<1>({}));
+    }
+    // The bus is silent, full discovery is performed.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 1, 123});
+        poll(node, 1'000us);
+        poll(node, 1'100'000us);
+        REQUIRE(driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        poll(node, 1'101'000us);  // Validation failed, switching to the bit rate detection.
+        REQUIRE(driver.getConfig()->bitrate == br);
+        poll(node, 1'102'000us);  // The bit rate detection retries the old bit rate first.
+        REQUIRE(driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == br);
+        poll(node, 2'300'000us);  // Then the standard bit rates are tried.
+        REQUIRE(driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == kocherga::can::ICANDriver::StandardBitrates.front());
+    }
+    // An invalid profile is ignored.
+    {
+        CANDriverMock driver;
+        driver.setMode(kocherga::can::ICANDriver::Mode::FD);
+        CANNode node(driver, uid, CANNetworkProfile{br, 2, 123});
+        poll(node, 1'000us);
+        REQUIRE(driver.getConfig()->silent);
+        REQUIRE(driver.getConfig()->bitrate == kocherga::can::ICANDriver::StandardBitrates.front());
+    }
+}
+
+TEST_CASE("can::RedundantCANDriver")
+{
+    using kocherga::can::RedundantCANDriver;
+    using Mode = kocherga::can::ICANDriver::Mode;
+    using Buf  = std::vector<std::uint8_t>;
+
+    CANDriverMock a;
+    CANDriverMock b;
+    CANDriverMock c;
+    a.setMode(Mode::FD);
+    b.setMode(Mode::Classic);
+    c.setMode(Mode::FD);
+    a.setMaxAcceptanceFilters(3);
+    b.setMaxAcceptanceFilters(2);
+    c.setMaxAcceptanceFilters(4);
+    RedundantCANDriver red(a, b, c);
+    static_assert(std::is_same_v<decltype(red), RedundantCANDriver<3>>);
+    auto& drv = static_cast<kocherga::can::ICANDriver&>(red);
+
+    // Not configured yet, nothing goes through.
+    kocherga::can::ICANDriver::PayloadBuffer buf{};
+    REQUIRE(!drv.push(false, 123, 1, "\x01"));
+    a.pushRx({123, {0b1110'0000U}});
+    REQUIRE(!drv.pop(buf));
+
+    // Configuration: the weakest controller determines the mode and the number of filters.
+    const Bitrate br{500'000, 2'000'000};
+    REQUIRE(drv.getMaxAcceptanceFilters() == 2);
+    REQUIRE(Mode::Classic == drv.configure(br, false, CANAcceptanceFilterConfig::makePromiscuous()));
+    for (const auto* const d : {&a, &b, &c})
+    {
+        REQUIRE(d->getConfig()->bitrate == br);
+        REQUIRE(!d->getConfig()->silent);
+    }
+    const std::array<CANAcceptanceFilterConfig, 2> filters{{{0x100, 0x1FF}, {0x200, 0x2FF}}};
+    REQUIRE(Mode::Classic == drv.configureMulti(br, true, filters.size(), filters.data()));
+    REQUIRE(c.getConfig()->filters.size() == 2);
+    REQUIRE(c.getConfig()->silent);
+    REQUIRE(!drv.getProtocolErrorCount());  // The mock does not support error reporting.
+
+    // Each frame is sent via every bus.
+    REQUIRE(drv.push(true, 123, 3, "\x01\x02\x03"));
+    for (auto* const d : {&a, &b, &c})
+    {
+        const auto f = d->popTx();
+        REQUIRE(f);
+        REQUIRE(f->extended_can_id == 123);
+        REQUIRE(f->force_classic_can);
+        REQUIRE(f->payload == Buf{1, 2, 3});
+        REQUIRE(!d->popTx());
+    }
+
+    // The first bus that delivers the start of a transfer wins; the copies from the other buses are dropped.
+    const CANDriverMock::Frame f0{0x1234, {1, 2, 3, 4, 5, 6, 7, 0b1010'0011U}};  // Start, transfer-ID 3.
+    const CANDriverMock::Frame f1{0x1234, {8, 9, 0b0100'0011U}};                 // End, transfer-ID 3.
+    const CANDriverMock::Frame g0{0x1234, {0b1110'0100U}};                       // Single frame, transfer-ID 4.
+    const CANDriverMock::Frame h0{0x5678, {0b1110'0011U}};                       // Another session.
+    const auto pop = [&drv, &buf]() -> std::optional<CANDriverMock::Frame> {
+        if (const auto f = drv.pop(buf))
+        {
+            return CANDriverMock::Frame{f->first, Buf(buf.begin(), buf.begin() + f->second)};
+        }
+        return {};
+    };
+    a.pushRx(f0);  // Stale frames queued before the configuration are still delivered.
+    b.pushRx(f0);
+    c.pushRx(h0);
+    b.pushRx(f1);
+    a.pushRx(f1);
+    c.pushRx(f0);
+    c.pushRx(f1);
+    REQUIRE(pop()->payload == Buf{0b1110'0000U});  // The stale frame from bus A.
+    REQUIRE(pop()->payload == f0.payload);         // From bus B.
+    REQUIRE(pop()->payload == h0.payload);         // From bus C.
+    REQUIRE(pop()->payload == f1.payload);         // From bus B; the duplicates from A and C are dropped.
+    REQUIRE(!pop());
+    // The next transfer is received via bus C first, it becomes the preferred source.
+    c.pushRx(g0);
+    a.pushRx(g0);
+    b.pushRx(g0);
+    REQUIRE(pop()->payload == g0.payload);
+    REQUIRE(!pop());
+
+    // A lagging bus delivers a stale transfer after a newer one was received over another bus; it is dropped.
+    const CANDriverMock::Frame k4{0x4321, {0b1110'0100U}};  // Single frame, transfer-ID 4.
+    const CANDriverMock::Frame k5{0x4321, {0b1110'0101U}};  // Single frame, transfer-ID 5.
+    const CANDriverMock::Frame k6{0x4321, {0b1110'0110U}};  // Single frame, transfer-ID 6.
+    a.pushRx(k4);
+    REQUIRE(pop()->payload == k4.payload);
+    a.pushRx(k5);
+    REQUIRE(pop()->payload == k5.payload);
+    b.pushRx(k4);
+    REQUIRE(!pop());
+    b.pushRx(k5);
+    REQUIRE(!pop());
+    b.pushRx(k6);  // Bus B is ahead now, it takes over.
+    REQUIRE(pop()->payload == k6.payload);
+    a.pushRx(k6);
+    REQUIRE(!pop());
+    // The remote node is restarted while bus B is down: bus A is accepted again once B is considered lost.
+    // The duplicate above is counted as well because bus B has not delivered anything since.
+    for (std::uint8_t i = 0; i < (RedundantCANDriver<3>::SessionTimeout - 2U); i++)
+    {
+        a.pushRx(k4);
+        REQUIRE(!pop());
+    }
+    a.pushRx(k5);
+    REQUIRE(pop()->payload == k5.payload);
+    b.pushRx(k5);
+    REQUIRE(!pop());
+
+    // A faulted controller is excluded, the others keep working.
+    b.setMode({});
+    REQUIRE(Mode::FD == drv.configure(br, false, CANAcceptanceFilterConfig::makePromiscuous()));
+    REQUIRE(drv.push(false, 123, 1, "\x01"));
+    REQUIRE(a.popTx());
+    REQUIRE(!b.popTx());
+    REQUIRE(c.popTx());
+    a.setMode({});
+    c.setMode({});
+    REQUIRE(!drv.configure(br, false, CANAcceptanceFilterConfig::makePromiscuous()));
+    REQUIRE(!drv.push(false, 123, 1, "\x01"));
+}
+
+TEST_CASE("can::CANNode redundant")
+{
+    using kocherga::ServiceID;
+    using kocherga::can::CANNode;
+    using kocherga::can::RedundantCANDriver;
+    using Buf = std::vector<std::uint8_t>;
+
+    CANDriverMock a;
+    CANDriverMock b;
+    a.setMode(kocherga::can::ICANDriver::Mode::FD);
+    b.setMode(kocherga::can::ICANDriver::Mode::FD);
+    RedundantCANDriver driver(a, b);
+    ReactorMock        reactor;
+    CANNode            node(driver, kocherga::SystemInfo::UniqueID{}, Bitrate{1'000'000, 4'000'000}, 1, 123);
+
+    std::size_t request_count = 0;
+    reactor.setIncomingRequestHandler([&request_count](const ReactorMock::IncomingRequest& req) -> std::optional<Buf> {
+        REQUIRE(req.service_id == static_cast<kocherga::PortID>(ServiceID::NodeGetInfo));
+        REQUIRE(req.client_node_id == 42);
+        request_count++;
+        return Buf{1, 2, 3};
+    });
+    // The same request arrives via both buses, it is processed once, and the response is sent to both buses.
+    const CANDriverMock::Frame request{
+        (0b110'11'0000000000'0000000'0000000UL |                        // Request
+         (static_cast<std::uint32_t>(ServiceID::NodeGetInfo) << 14U) |  // Service-ID
+         (static_cast<std::uint32_t>(123) << 7U) |                      // Destination node-ID
+         (static_cast<std::uint32_t>(42) << 0U)),                       // Source node-ID
+        {0b1110'0000U},
+    };
+    a.pushRx(request);
+    b.pushRx(request);
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+    REQUIRE(request_count == 1);
+    for (auto* const d : {&a, &b})
+    {
+        const auto f = d->popTx();
+        REQUIRE(f);
+        REQUIRE(f->payload == Buf{1, 2, 3, 0b1110'0000U});
+        REQUIRE(!d->popTx());
+    }
+}
+
+TEST_CASE("can::detail::MainActivity early rejection")
+{
+    using kocherga::can::detail::IActivity;
+    using kocherga::can::detail::V0MainActivity;
+    using kocherga::can::detail::V1MainActivity;
+    using Mode = kocherga::can::ICANDriver::Mode;
+    using Buf  = std::vector<std::uint8_t>;
+
+    const Bitrate br{1'000'000, 4'000'000};
+    ReactorMock   reactor;
+    std::size_t   request_count = 0;
+    reactor.setIncomingRequestHandler([&request_count](const ReactorMock::IncomingRequest& req) -> std::optional<Buf> {
+        REQUIRE(req.service_id == static_cast<kocherga::PortID>(kocherga::ServiceID::NodeGetInfo));
+        REQUIRE(req.client_node_id == 42);
+        request_count++;
+        return Buf{1, 2, 3};
+    });
+
+    // v1
+    {
+        CANDriverMock driver;
+        driver.setMode(Mode::FD);
+        V1MainActivity act(driver, br, Mode::FD, 123);
+        driver.pushRx({0x10'7D'55'2AUL, {0, 0, 0, 0, 0, 0, 0, 0b1110'0000U}});  // Heartbeat
+        driver.pushRx({0b110'11'0110101110'1111010'0101010UL, {0b1110'0000U}});  // GetInfo request to another node
+        driver.pushRx({0b110'11'0110101110'1111011'0101010UL, {0b1110'0000U}});  // GetInfo request to us
+        REQUIRE(!static_cast<IActivity&>(act).poll(reactor, std::chrono::microseconds(1'000)));
+        REQUIRE(act.getRejectedFrameCount() == 2);
+        REQUIRE(request_count == 1);
+        REQUIRE(driver.popTx()->payload == Buf{1, 2, 3, 0b1110'0000U});
+        REQUIRE(!driver.popTx());
+    }
+    // v0
+    {
+        CANDriverMock driver;
+        driver.setMode(Mode::Classic);
+        V0MainActivity act(driver, br, 123);
+        driver.pushRx({0x10'01'55'2AUL, {0, 0, 0, 0, 0, 0, 0b1100'0000U}});  // NodeStatus
+        driver.pushRx({0x1E'01'FA'AAUL, {0b1100'0000U}});                    // GetNodeInfo request to another node
+        driver.pushRx({0x1E'01'FB'AAUL, {0b1100'0000U}});                    // GetNodeInfo request to us
+        REQUIRE(!static_cast<IActivity&>(act).poll(reactor, std::chrono::microseconds(1'000)));
+        REQUIRE(act.getRejectedFrameCount() == 2);
+        REQUIRE(request_count == 2);  // The response is not sent because the mock GetInfo response is malformed.
+    }
+}
+
+TEST_CASE("can::detail::V1MainActivity frame size")
+{
+    using kocherga::can::detail::IActivity;
+    using kocherga::can::detail::V1MainActivity;
+    using Mode = kocherga::can::ICANDriver::Mode;
+    using Buf  = std::vector<std::uint8_t>;
+
+    ReactorMock reactor;
+    reactor.setIncomingRequestHandler([](const ReactorMock::IncomingRequest&) -> std::optional<Buf> {
+        return Buf(100, 0xAAU);  // Not a valid GetInfo response but the activity does not care.
+    });
+    const auto run = [&reactor](const Bitrate& br, const Mode mode, const std::size_t max_fd_payload_size) {
+        CANDriverMock driver;
+        driver.setMode(mode);
+        driver.setMaxFDPayloadSize(max_fd_payload_size);
+        V1MainActivity act(driver, br, mode, 123);
+        driver.pushRx({0b110'11'0110101110'1111011'0101010UL, {0b1110'0000U}});  // GetInfo request to us
+        REQUIRE(!static_cast<IActivity&>(act).poll(reactor, std::chrono::microseconds(1'000)));
+        std::vector<std::size_t> out;
+        while (const auto f = driver.popTx())
+        {
+            REQUIRE(!f->force_classic_can);
+            out.push_back(f->payload.size());
+        }
+        return out;
+    };
+    // With BRS, the largest frames are the cheapest.
+    REQUIRE(run({1'000'000, 4'000'000}, Mode::FD, 64) == std::vector<std::size_t>{64, 48});
+    // The driver limit is honored.
+    REQUIRE(run({1'000'000, 4'000'000}, Mode::FD, 32) == std::vector<std::size_t>{32, 32, 32, 12});
+    REQUIRE(run({1'000'000, 4'000'000}, Mode::FD, 20) == std::vector<std::size_t>{20, 20, 20, 20, 20, 8});
+    // Classic CAN ignores the FD limit.
+    REQUIRE(run({1'000'000, 0}, Mode::Classic, 64).size() == 15);
+}
+
+TEST_CASE("can::detail::MainActivity request retransmission")
+{
+    using kocherga::can::detail::IActivity;
+    using kocherga::can::detail::V0MainActivity;
+    using kocherga::can::detail::V1MainActivity;
+    using Mode = kocherga::can::ICANDriver::Mode;
+
+    // uavcan.file.Read.Request: offset, path length, path.
+    std::vector<std::uint8_t> request{0x00, 0x10, 0x00, 0x00, 0x00, 23};
+    for (const char ch : std::string("/firmware/image.app.bin"))
+    {
+        request.push_back(static_cast<std::uint8_t>(ch));
+    }
+    const auto run = [&request](CANDriverMock& driver, IActivity& act) {
+        const auto drain = [&driver] {
+            std::vector<CANDriverMock::TxFrame> out;
+            while (const auto f = driver.popTx())
+            {
+                out.push_back(*f);
+            }
+            return out;
+        };
+        REQUIRE(act.sendRequest(kocherga::ServiceID::FileRead, 42, 3, request.size(), request.data()));
+        const auto first = drain();
+        REQUIRE(first.size() > 1);
+        REQUIRE(act.resendRequest(kocherga::ServiceID::FileRead, 42, 4, request.size(), request.data()));
+        const auto second = drain();
+        // The retransmission differs from the original only in the transfer-ID in the tail bytes.
+        REQUIRE(first.size() == second.size());
+        for (std::size_t i = 0; i < first.size(); i++)
+        {
+            REQUIRE(first.at(i).extended_can_id == second.at(i).extended_can_id);
+            auto expected   = first.at(i).payload;
+            expected.back()      = static_cast<std::uint8_t>((expected.back() & 0xE0U) | 4U);
+            REQUIRE(expected == second.at(i).payload);
+        }
+    };
+    {
+        CANDriverMock driver;
+        driver.setMode(Mode::Classic);
+        V1MainActivity act(driver, Bitrate{1'000'000, 0}, Mode::Classic, 123);
+        run(driver, act);
+    }
+    {
+        CANDriverMock driver;
+        driver.setMode(Mode::Classic);
+        V0MainActivity act(driver, Bitrate{1'000'000, 0}, 123);
+        run(driver, act);
+    }
+}
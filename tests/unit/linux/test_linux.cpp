@@ -0,0 +1,430 @@
+// This software is distributed under the terms of the MIT License.
+// Copyright (c) 2021 Zubax Robotics.
+// Author: Pavel Kirienko <pavel.kirienko@zubax.com>
+
+#include "kocherga_linux.hpp"  // NOLINT include order: include Kocherga first to ensure no headers are missed.
+#include "catch.hpp"
+#include "../mock.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+auto makeSocketPair() -> std::pair<int, int>
+{
+    std::array<int, 2> fds{};
+    REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()));
+    REQUIRE(0 == ::fcntl(fds.at(1), F_SETFL, ::fcntl(fds.at(1), F_GETFL) | O_NONBLOCK));  // NOLINT vararg
+    return {fds.at(0), fds.at(1)};
+}
+
+auto readAll(const int fd) -> std::vector<std::uint8_t>
+{
+    std::vector<std::uint8_t>       out;
+    std::array<std::uint8_t, 1024> buf{};
+    while (true)
+    {
+        const auto sz = ::read(fd, buf.data(), buf.size());
+        if (sz <= 0)
+        {
+            break;
+        }
+        out.insert(out.end(), buf.begin(), buf.begin() + sz);
+    }
+    return out;
+}
+
+/// Closes the file descriptor when leaving the scope, including when a REQUIRE() fails.
+class FileDescriptorGuard final
+{
+public:
+    explicit FileDescriptorGuard(const int fd) : fd_(fd) {}
+    ~FileDescriptorGuard()
+    {
+        if (fd_ >= 0)
+        {
+            (void) ::close(fd_);
+        }
+    }
+    FileDescriptorGuard(const FileDescriptorGuard&)                    = delete;
+    FileDescriptorGuard(FileDescriptorGuard&&)                         = delete;
+    auto operator=(const FileDescriptorGuard&) -> FileDescriptorGuard& = delete;
+    auto operator=(FileDescriptorGuard&&) -> FileDescriptorGuard&      = delete;
+
+private:
+    const int fd_;
+};
+
+/// A bare socket for testing the runner; the test performs the I/O on it directly.
+class SocketSource final : public kocherga::os_linux::IEventSource
+{
+public:
+    explicit SocketSource(const int fd) : fd_(fd) {}
+    [[nodiscard]] auto getFileDescriptor() const -> int override { return fd_; }
+    [[nodiscard]] auto hasBufferedInput() const -> bool override { return false; }
+    [[nodiscard]] auto flush() -> bool override { return false; }
+    [[nodiscard]] auto getRetryTime() const -> std::optional<std::chrono::steady_clock::time_point> override
+    {
+        return retry_time;
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> retry_time;
+
+private:
+    const int fd_;
+};
+
+auto makeLoopbackUDPSocket() -> std::pair<int, ::sockaddr_in>
+{
+    const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    REQUIRE(fd >= 0);
+    ::sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    REQUIRE(0 == ::bind(fd, reinterpret_cast<const ::sockaddr*>(&addr), sizeof(addr)));  // NOLINT reinterpret_cast
+    ::socklen_t len = sizeof(addr);
+    REQUIRE(0 == ::getsockname(fd, reinterpret_cast<::sockaddr*>(&addr), &len));  // NOLINT reinterpret_cast
+    return {fd, addr};
+}
+
+}  // namespace
+
+TEST_CASE("os_linux::StreamSerialPort")
+{
+    using kocherga::os_linux::StreamSerialPort;
+    const auto [local, remote] = makeSocketPair();
+    StreamSerialPort port(local);
+    REQUIRE(port.getFileDescriptor() == local);
+
+    // The output is buffered until flushed.
+    for (std::uint32_t i = 0; i < 3000; i++)
+    {
+        REQUIRE(port.send(static_cast<std::uint8_t>(i)));
+    }
+    REQUIRE(readAll(remote).empty());
+    REQUIRE(!port.flush());
+    const auto tx = readAll(remote);
+    REQUIRE(tx.size() == 3000);
+    for (std::size_t i = 0; i < tx.size(); i++)
+    {
+        REQUIRE(tx.at(i) == static_cast<std::uint8_t>(i));
+    }
+
+    // The input is read in blocks; the block is served from the buffer without further syscalls.
+    std::vector<std::uint8_t> rx_ref(StreamSerialPort::BufferSize + 123U);
+    for (std::size_t i = 0; i < rx_ref.size(); i++)
+    {
+        rx_ref.at(i) = static_cast<std::uint8_t>(i * 7U);
+    }
+    REQUIRE(!port.receive());
+    REQUIRE(!port.hasBufferedInput());
+    REQUIRE(::write(remote, rx_ref.data(), rx_ref.size()) == static_cast<::ssize_t>(rx_ref.size()));
+    REQUIRE(port.receive() == rx_ref.at(0));
+    REQUIRE(port.hasBufferedInput());
+    for (std::size_t i = 1; i < rx_ref.size(); i++)
+    {
+        REQUIRE(port.receive() == rx_ref.at(i));
+    }
+    REQUIRE(!port.hasBufferedInput());
+    REQUIRE(!port.receive());
+
+    // If the peer does not read, the output stays pending once the kernel buffer is full; the overflow is rejected.
+    std::size_t accepted = 0;
+    while (port.send(0xAA) && (accepted < 100'000'000))
+    {
+        accepted++;
+    }
+    REQUIRE(accepted >= StreamSerialPort::BufferSize);
+    REQUIRE(accepted < 100'000'000);
+    REQUIRE(port.flush());
+    REQUIRE(readAll(remote).size() + StreamSerialPort::BufferSize >= accepted);
+    REQUIRE(!port.flush());
+    (void) ::close(remote);
+}
+
+TEST_CASE("os_linux::EpollRunner")
+{
+    using kocherga::os_linux::EpollRunner;
+    using kocherga::os_linux::StreamSerialPort;
+    using std::chrono_literals::operator""ms;
+    using std::chrono_literals::operator""s;
+
+    EpollRunner runner;
+    REQUIRE(runner.isValid());
+    const auto [local, remote] = makeSocketPair();
+    StreamSerialPort port(local);
+    REQUIRE(runner.add(port));
+
+    // The wait ends early when a source becomes readable.
+    REQUIRE(::write(remote, "x", 1) == 1);
+    auto started_at = runner.getUptime();
+    REQUIRE(runner.wait(5s));
+    REQUIRE((runner.getUptime() - started_at) < 1s);
+    REQUIRE(port.receive() == 'x');
+    REQUIRE(!runner.service());  // No buffered input left.
+
+    // The pending output is awaited until the source becomes writable.
+    REQUIRE(port.send(1));
+    REQUIRE(!runner.service());  // Flushed immediately.
+    REQUIRE(readAll(remote).size() == 1);
+
+    // Once the peer hangs up, the source is no longer waited for, so the timeout is honored instead of spinning.
+    (void) ::close(remote);
+    REQUIRE(runner.wait(5s));
+    started_at = runner.getUptime();
+    REQUIRE(runner.wait(100ms));
+    REQUIRE((runner.getUptime() - started_at) >= 100ms);
+
+    // The bootloader is polled only when it has something to do: the heartbeat and the end of the boot delay.
+    const auto img = util::getImagePath("good-le-simple-3.1.badc0ffee0ddf00d.452a4267971a3928.app.release.bin");
+    util::FileROMBackend         rom(img);
+    mock::Node                   node;
+    kocherga::Bootloader::Params params;
+    params.max_app_size = static_cast<std::size_t>(std::filesystem::file_size(img));
+    params.boot_delay   = 1s;
+    kocherga::Bootloader bl(rom, kocherga::SystemInfo{}, params);
+    REQUIRE(bl.addNode(&node));
+    started_at = runner.getUptime();
+    REQUIRE(runner.run(bl) == kocherga::Final::BootApp);
+    REQUIRE((runner.getUptime() - started_at) >= 1s);
+    REQUIRE(node.getPollCount() > 0);
+    REQUIRE(node.getPollCount() < 10);
+}
+
+TEST_CASE("os_linux::EpollRunner socket error")
+{
+    using kocherga::os_linux::EpollRunner;
+    using std::chrono_literals::operator""s;
+
+    // A socket error is not terminal: once the source has read it, the socket is waited for again.
+    EpollRunner runner;
+    REQUIRE(runner.isValid());
+    const auto [sock, sock_addr] = makeLoopbackUDPSocket();
+    auto [peer, peer_addr]       = makeLoopbackUDPSocket();
+    (void) ::close(peer);  // The port is unreachable now, so the datagram below bounces back as an error.
+    REQUIRE(0 == ::connect(sock, reinterpret_cast<const ::sockaddr*>(&peer_addr), sizeof(peer_addr)));  // NOLINT
+    SocketSource source(sock);
+    REQUIRE(runner.add(source));
+    REQUIRE(::send(sock, "x", 1, 0) == 1);
+    auto started_at = runner.getUptime();
+    REQUIRE(runner.wait(5s));
+    REQUIRE((runner.getUptime() - started_at) < 1s);
+    std::array<char, 8> buf{};
+    REQUIRE(::recv(sock, buf.data(), buf.size(), 0) < 0);  // Reading the error clears it.
+    REQUIRE(errno == ECONNREFUSED);
+    peer = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);  // The port is reachable again.
+    REQUIRE(0 == ::bind(peer, reinterpret_cast<const ::sockaddr*>(&peer_addr), sizeof(peer_addr)));  // NOLINT
+    REQUIRE(::sendto(peer,
+                     "y",
+                     1,
+                     0,
+                     reinterpret_cast<const ::sockaddr*>(&sock_addr),  // NOLINT reinterpret_cast
+                     sizeof(sock_addr)) == 1);
+    started_at = runner.getUptime();
+    REQUIRE(runner.wait(5s));
+    REQUIRE((runner.getUptime() - started_at) < 1s);
+    REQUIRE(::recv(sock, buf.data(), buf.size(), 0) == 1);
+    REQUIRE(buf.at(0) == 'y');
+    (void) ::close(peer);
+    (void) ::close(sock);
+
+    // A timed retry requested by the source limits the wait although the fd is not ready.
+    source.retry_time = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    REQUIRE(!runner.service());
+    REQUIRE(runner.getRetryDeadline());
+    REQUIRE(*runner.getRetryDeadline() <= (runner.getUptime() + std::chrono::milliseconds(50)));
+    source.retry_time.reset();
+    REQUIRE(!runner.service());
+    REQUIRE(!runner.getRetryDeadline());
+}
+
+TEST_CASE("os_linux::SocketCANDriver TX errors")
+{
+    using kocherga::os_linux::SocketCANDriver;
+    const std::array<std::uint8_t, 8> payload{1, 2, 3, 4, 5, 6, 7, 0b1110'0000};
+
+    // The frames that the kernel rejects outright are dropped instead of blocking the queue until they time out.
+    // A datagram socket without a destination is used in place of a CAN socket to provoke an error (EDESTADDRREQ).
+    {
+        SocketCANDriver drv(::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+        REQUIRE(drv.push(true, 123, payload.size(), payload.data()));
+        REQUIRE(drv.push(false, 456, payload.size(), payload.data()));
+        REQUIRE(!drv.flush());
+        REQUIRE(drv.getStatistics().tx_errors == 2);
+        REQUIRE(drv.getStatistics().frames_sent == 0);
+        REQUIRE(!drv.getRetryTime());
+    }
+
+    // If the socket buffer is full, the frames stay queued until the socket becomes writable (EAGAIN).
+    {
+        std::array<int, 2> fds{};
+        REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds.data()));
+        SocketCANDriver drv(fds.at(0));
+        bool            pending = false;
+        for (std::size_t i = 0; (i < 1'000) && !pending; i++)
+        {
+            REQUIRE(drv.push(true, 123, payload.size(), payload.data()));
+            pending = drv.flush();
+        }
+        REQUIRE(pending);
+        REQUIRE(drv.getStatistics().frames_sent > 0);
+        REQUIRE(drv.getStatistics().tx_errors == 0);
+        REQUIRE(!drv.getRetryTime());  // The runner waits for EPOLLOUT instead.
+        (void) ::close(fds.at(1));
+    }
+}
+
+TEST_CASE("os_linux::SocketCANDriver vcan benchmark")
+{
+    using kocherga::os_linux::openSocketCAN;
+    using kocherga::os_linux::SocketCANDriver;
+    using kocherga::can::CANAcceptanceFilterConfig;
+    using Clock = std::chrono::steady_clock;
+
+    // Requires a virtual CAN interface: ip link add dev vcan0 type vcan && ip link set up vcan0
+    const char* const env   = std::getenv("KOCHERGA_TEST_VCAN");  // NOLINT thread safety
+    const std::string iface = (env != nullptr) ? env : "vcan0";
+    const int         tx_fd = openSocketCAN(iface.c_str());
+    const int         rx_fd = openSocketCAN(iface.c_str());
+    if ((tx_fd < 0) || (rx_fd < 0))
+    {
+        (void) ::close(tx_fd);
+        (void) ::close(rx_fd);
+        WARN("SocketCAN interface " << iface << " is not available, skipping");
+        return;
+    }
+    SocketCANDriver::Params params;
+    params.send_buffer_size    = 1024 * 1024;
+    params.receive_buffer_size = 1024 * 1024;
+    SocketCANDriver tx(tx_fd, params);
+    SocketCANDriver rx(rx_fd, params);
+    REQUIRE(tx.configure({1'000'000, 0}, false, CANAcceptanceFilterConfig::makePromiscuous()));
+    // The receiver accepts only the frames whose low 7 bits (the source node-ID) equal 42.
+    REQUIRE(rx.configure({1'000'000, 0}, false, CANAcceptanceFilterConfig{42, 0x7F}));
+
+    static constexpr std::size_t      Bursts = 1'000;
+    const std::array<std::uint8_t, 8> payload{1, 2, 3, 4, 5, 6, 7, 0b1110'0000};
+    std::size_t                       received = 0;
+    const auto                        started  = Clock::now();
+    for (std::size_t burst = 0; burst < Bursts; burst++)
+    {
+        for (std::uint32_t i = 0; i < SocketCANDriver::BatchSize; i++)
+        {
+            // Every other frame is rejected by the kernel filter of the receiver.
+            REQUIRE(tx.push(true, (i << 8U) | (((i % 2U) == 0) ? 42U : 43U), payload.size(), payload.data()));
+        }
+        REQUIRE(!tx.flush());
+        kocherga::can::ICANDriver::PayloadBuffer buf{};
+        while (const auto frame = rx.pop(buf))
+        {
+            REQUIRE((frame->first & 0x7FU) == 42U);
+            REQUIRE(frame->second == payload.size());
+            REQUIRE(buf.at(7) == payload.at(7));
+            received++;
+        }
+    }
+    const auto elapsed = Clock::now() - started;
+    const auto sent    = Bursts * SocketCANDriver::BatchSize;
+    REQUIRE(tx.getStatistics().frames_sent == sent);
+    REQUIRE(tx.getStatistics().tx_queue_full == 0);
+    REQUIRE(received == (sent / 2U));
+    REQUIRE(rx.getStatistics().frames_received == received);
+    std::cout << "SocketCAN: "
+              << static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+                     static_cast<double>(sent)
+              << " ns/frame; " << static_cast<double>(sent) / static_cast<double>(tx.getStatistics().syscalls)
+              << " TX frames/syscall" << std::endl;
+
+    // In the silent mode nothing is transmitted; the refusal is reported to the caller.
+    REQUIRE(tx.configure({1'000'000, 0}, true, CANAcceptanceFilterConfig::makePromiscuous()));
+    REQUIRE(!tx.push(true, 42U, payload.size(), payload.data()));
+}
+
+TEST_CASE("os_linux::openTTY pty benchmark")
+{
+    using kocherga::os_linux::openTTY;
+    using kocherga::os_linux::StreamSerialPort;
+    using Clock = std::chrono::steady_clock;
+
+    errno = 0;
+    REQUIRE(openTTY("/dev/nonexistent-tty", 115'200) < 0);
+    REQUIRE(errno == ENOENT);
+
+    const int                 master = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);  // NOLINT signed bitwise
+    const FileDescriptorGuard master_guard(master);
+    if ((master < 0) || (0 != ::grantpt(master)) || (0 != ::unlockpt(master)))
+    {
+        WARN(std::string("Skipping the pty test: ") + std::strerror(errno));
+        return;
+    }
+    const std::string slave_path = ::ptsname(master);  // NOLINT not thread-safe, but there are no other threads
+    errno                        = 0;
+    REQUIRE(openTTY(slave_path.c_str(), 12'345) < 0);  // Not a standard baud rate.
+    REQUIRE(errno == EINVAL);
+    const int fd = openTTY(slave_path.c_str(), 921'600);
+    REQUIRE(fd >= 0);
+    StreamSerialPort port(fd);  // Takes the ownership of the file descriptor.
+    ::termios        tio{};
+    REQUIRE(0 == ::tcgetattr(fd, &tio));
+    REQUIRE(::cfgetospeed(&tio) == B921600);
+    REQUIRE((tio.c_lflag & static_cast<::tcflag_t>(ICANON | ECHO)) == 0);
+    REQUIRE((tio.c_oflag & static_cast<::tcflag_t>(OPOST)) == 0);
+
+    // Stream the data through the pty in both directions the way SerialNode does: 256-byte blocks per call.
+    static constexpr std::size_t Total = 1024U * 1024U;
+    const auto pattern = [](const std::size_t index) {
+        return static_cast<std::uint8_t>((index * 7U) + (index >> 10U));
+    };
+    std::vector<std::uint8_t>      out(Total);
+    std::array<std::uint8_t, 4096> wire{};
+    std::array<std::uint8_t, 256>  chunk{};
+    for (std::size_t i = 0; i < Total; i++)
+    {
+        out.at(i) = pattern(i);
+    }
+    std::size_t written  = 0;  // By the master.
+    std::size_t received = 0;  // By the port.
+    std::size_t sent     = 0;  // By the port.
+    std::size_t read     = 0;  // By the master.
+    const auto  deadline = Clock::now() + std::chrono::seconds(30);
+    const auto  started  = Clock::now();
+    while (((received < Total) || (read < Total)) && (Clock::now() < deadline))
+    {
+        if (written < Total)
+        {
+            const auto n = ::write(master, &out.at(written), std::min(wire.size(), Total - written));
+            written += (n > 0) ? static_cast<std::size_t>(n) : 0U;
+        }
+        while (const auto n = port.receiveBlock(chunk.data(), chunk.size()))
+        {
+            for (std::size_t i = 0; i < n; i++)
+            {
+                REQUIRE(chunk.at(i) == pattern(received + i));
+            }
+            received += n;
+        }
+        if (sent < Total)
+        {
+            sent += port.sendBlock(&out.at(sent), std::min(chunk.size(), Total - sent));
+        }
+        (void) port.flush();
+        const auto n = ::read(master, wire.data(), wire.size());
+        for (std::size_t i = 0; i < static_cast<std::size_t>(std::max<::ssize_t>(n, 0)); i++)
+        {
+            REQUIRE(wire.at(i) == pattern(read + i));
+        }
+        read += (n > 0) ? static_cast<std::size_t>(n) : 0U;
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    REQUIRE(received == Total);
+    REQUIRE(read == Total);
+    const auto& stats = port.getStatistics();
+    REQUIRE(stats.bytes_received == Total);
+    REQUIRE(stats.bytes_sent == Total);
+    std::cout << "StreamSerialPort over pty: " << (static_cast<double>(Total * 2U) / elapsed / 1e6) << " MB/s, "
+              << (static_cast<double>(stats.syscalls) / (static_cast<double>(Total * 2U) / 1024.0))
+              << " syscalls/KiB" << std::endl;
+}
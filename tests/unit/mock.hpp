@@ -68,6 +68,8 @@ public:
 
     [[nodiscard]] auto getLastPollTime() const { return last_poll_at_; }
 
+    [[nodiscard]] auto getPollCount() const { return poll_count_; }
+
     [[nodiscard]] auto wasRequestCanceled()
     {
         const auto out    = request_canceled_;
@@ -77,6 +79,16 @@ public:
 
     void setFileReadResult(const bool value) { file_read_result_ = value; }
 
+    void setNextDeadline(const std::optional<std::chrono::microseconds> value) { next_deadline_ = value; }
+
+    /// The number of resendRequest() invocations since the last check.
+    [[nodiscard]] auto popResendCount()
+    {
+        const auto out = resend_count_;
+        resend_count_  = 0;
+        return out;
+    }
+
     /// Retrieve a previously received transfer under the specified session.
     /// Return an empty option if no such transfer was received since the last retrieval.
     /// The read is destructive -- the transfer is removed afterwards.
@@ -118,6 +130,7 @@ private:
         };
 
         last_poll_at_ = uptime;
+        poll_count_++;
         for (auto [key, tr] : inputs_)
         {
             switch (key)
@@ -169,8 +182,23 @@ private:
         }
     }
 
+    [[nodiscard]] auto resendRequest(const kocherga::ServiceID  service_id,
+                                     const kocherga::NodeID     server_node_id,
+                                     const kocherga::TransferID transfer_id,
+                                     const std::size_t          payload_length,
+                                     const std::uint8_t* const  payload) -> bool override
+    {
+        resend_count_++;
+        return sendRequest(service_id, server_node_id, transfer_id, payload_length, payload);
+    }
+
     void cancelRequest() override { request_canceled_ = true; }
 
+    [[nodiscard]] auto getNextDeadline() const -> std::optional<std::chrono::microseconds> override
+    {
+        return next_deadline_;
+    }
+
     [[nodiscard]] auto publishMessage(const kocherga::SubjectID  subject_id,
                                       const kocherga::TransferID transfer_id,
                                       const std::size_t          payload_length,
@@ -210,11 +238,14 @@ private:
         outputs_[ses] = tr;
     }
 
-    std::chrono::microseconds  last_poll_at_{};
-    bool                       file_read_result_ = true;
-    bool                       request_canceled_ = false;
-    std::map<Output, Transfer> outputs_;
-    std::map<Input, Transfer>  inputs_;
+    std::chrono::microseconds                last_poll_at_{};
+    std::uint32_t                            poll_count_ = 0;
+    std::optional<std::chrono::microseconds> next_deadline_;
+    bool                                     file_read_result_ = true;
+    bool                                     request_canceled_ = false;
+    std::uint32_t                            resend_count_     = 0;
+    std::map<Output, Transfer>               outputs_;
+    std::map<Input, Transfer>                inputs_;
 };
 
 }  // namespace mock
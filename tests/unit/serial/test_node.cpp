@@ -6,6 +6,9 @@
 #include "catch.hpp"
 #include <deque>
 #include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
 
 namespace
 {
@@ -60,6 +63,88 @@ private:
     kocherga::serial::detail::StreamParser<1024> stream_parser_;
 };
 
+/// Implements only the block API; the single-byte API shall not be used by the node.
+class BlockSerialPortMock : public kocherga::serial::ISerialPort
+{
+public:
+    void pushRx(const kocherga::serial::detail::Transfer& transfer)
+    {
+        REQUIRE(kocherga::serial::detail::transmit(
+            [this](const std::uint8_t bt) {
+                rx_.push_back(bt);
+                return true;
+            },
+            transfer));
+    }
+
+    void pushRx(const std::vector<std::uint8_t>& data) { rx_.insert(rx_.end(), data.begin(), data.end()); }
+
+    [[nodiscard]] auto getRxSize() const { return rx_.size(); }
+
+    [[nodiscard]] auto popTxRaw() -> std::vector<std::uint8_t>
+    {
+        std::vector<std::uint8_t> out(tx_.begin(), tx_.end());
+        tx_.clear();
+        return out;
+    }
+
+    [[nodiscard]] auto popTx() -> std::optional<kocherga::serial::detail::Transfer>
+    {
+        while (!tx_.empty())
+        {
+            const auto bt = tx_.front();
+            tx_.pop_front();
+            if (const auto tr = stream_parser_.update(bt))
+            {
+                return tr;
+            }
+        }
+        return {};
+    }
+
+    void setTxCapacity(const std::size_t value) { tx_capacity_ = value; }
+
+    [[nodiscard]] auto getRxCallCount() const { return rx_call_count_; }
+    [[nodiscard]] auto getTxCallCount() const { return tx_call_count_; }
+
+private:
+    [[nodiscard]] auto receive() -> std::optional<std::uint8_t> override
+    {
+        FAIL("Single-byte receive() invoked");
+        return {};
+    }
+
+    [[nodiscard]] auto send(const std::uint8_t) -> bool override
+    {
+        FAIL("Single-byte send() invoked");
+        return false;
+    }
+
+    [[nodiscard]] auto receiveBlock(std::uint8_t* const buffer, const std::size_t capacity) -> std::size_t override
+    {
+        rx_call_count_++;
+        const auto out = std::min(capacity, rx_.size());
+        std::copy_n(rx_.begin(), out, buffer);
+        rx_.erase(rx_.begin(), rx_.begin() + static_cast<std::ptrdiff_t>(out));
+        return out;
+    }
+
+    [[nodiscard]] auto sendBlock(const std::uint8_t* const data, const std::size_t size) -> std::size_t override
+    {
+        tx_call_count_++;
+        const auto out = std::min(size, tx_capacity_ - std::min(tx_capacity_, tx_.size()));
+        std::copy_n(data, out, std::back_inserter(tx_));
+        return out;
+    }
+
+    std::deque<std::uint8_t>                     tx_;
+    std::deque<std::uint8_t>                     rx_;
+    kocherga::serial::detail::StreamParser<1024> stream_parser_;
+    std::size_t                                  tx_capacity_   = std::numeric_limits<std::size_t>::max();
+    std::size_t                                  rx_call_count_ = 0;
+    std::size_t                                  tx_call_count_ = 0;
+};
+
 class ReactorMock : public kocherga::IReactor
 {
 public:
@@ -110,8 +195,14 @@ private:
         std::copy_n(response, response_length, std::back_insert_iterator(pending_responses_.back()));
     }
 
-    IncomingRequestHandler                request_handler_;
-    std::deque<std::vector<std::uint8_t>> pending_responses_;
+    [[nodiscard]] auto getResponseBuffer() -> std::pair<std::size_t, std::uint8_t*> override
+    {
+        return {response_buffer_.size(), response_buffer_.data()};
+    }
+
+    IncomingRequestHandler                                                       request_handler_;
+    std::deque<std::vector<std::uint8_t>>                                        pending_responses_;
+    std::array<std::uint8_t, kocherga::detail::dsdl::File::ReadResponseSizeMax> response_buffer_{};
 };
 
 }  // namespace
@@ -120,7 +211,9 @@ TEST_CASE("kocherga_serial::SerialNode service")
 {
     SerialPortMock               port;
     kocherga::serial::SerialNode node(port, {});
+    REQUIRE(static_cast<kocherga::INode&>(node).getNextDeadline() == std::chrono::microseconds(0));  // PnP pending.
     node.setLocalNodeID(2222);
+    REQUIRE(!static_cast<kocherga::INode&>(node).getNextDeadline());  // Nothing to do until data is received.
     ReactorMock reactor;
 
     // Send a request transfer and then pop a response.
@@ -320,3 +413,559 @@ TEST_CASE("kocherga_serial::SerialNode service")
         REQUIRE(!port.popTx());      // Ensure no responses are sent.
     }
 }
+
+TEST_CASE("kocherga_serial::SerialNode block I/O")
+{
+    BlockSerialPortMock          port;
+    kocherga::serial::SerialNode node(port, {});
+    node.setLocalNodeID(2222);
+    ReactorMock reactor;
+
+    // Many frames arrive at once; they are fetched from the port in a few large blocks rather than byte-by-byte.
+    kocherga::serial::detail::Transfer request;
+    request.meta.source      = 1111;
+    request.meta.destination = 2222;
+    request.meta.data_spec =
+        static_cast<std::uint16_t>(kocherga::ServiceID::NodeExecuteCommand) |
+        static_cast<std::uint16_t>(kocherga::serial::detail::Transfer::Metadata::DataSpecServiceFlag |
+                                   kocherga::serial::detail::Transfer::Metadata::DataSpecRequestFlag);
+    request.payload_len = 6;
+    request.payload     = reinterpret_cast<const std::uint8_t*>("\x05\x04\x03\x02\x01\x00");
+    for (auto i = 0U; i < 10; i++)
+    {
+        request.meta.transfer_id = i;
+        port.pushRx(request);
+    }
+    auto num_requests = 0;
+    reactor.setIncomingRequestHandler(
+        [&num_requests](const ReactorMock::IncomingRequest& ir) -> std::optional<std::vector<std::uint8_t>> {
+            num_requests++;
+            REQUIRE(ir.data == std::vector<std::uint8_t>{5, 4, 3, 2, 1, 0});
+            return std::vector<std::uint8_t>(300, 0xAA);  // Longer than one chunk.
+        });
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+    REQUIRE(num_requests == 10);
+    REQUIRE(port.getRxCallCount() < 5);
+    REQUIRE(port.getTxCallCount() < 30);  // At most a few calls per response frame.
+    for (auto i = 0U; i < 10; i++)
+    {
+        const auto response = port.popTx();
+        REQUIRE(response);
+        REQUIRE(response->meta.transfer_id == i);
+        REQUIRE(response->payload_len == 300);
+    }
+    REQUIRE(!port.popTx());
+
+    // If the port accepts only a part of the frame, the rest is kept in the TX queue and sent later.
+    port.setTxCapacity(100);
+    REQUIRE(static_cast<kocherga::INode&>(node).sendRequest(kocherga::ServiceID::NodeExecuteCommand,
+                                                            1111,
+                                                            0xCAFE'CAFE,
+                                                            200,
+                                                            std::vector<std::uint8_t>(200, 0x55).data()));
+    REQUIRE(!port.popTx());
+    REQUIRE(node.getTxQueueSize() > 0);
+    REQUIRE(static_cast<kocherga::INode&>(node).getNextDeadline() == std::chrono::microseconds(2'000));
+    port.setTxCapacity(std::numeric_limits<std::size_t>::max());
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+    REQUIRE(node.getTxQueueSize() == 0);
+    REQUIRE(!static_cast<kocherga::INode&>(node).getNextDeadline());
+    const auto sent = port.popTx();
+    REQUIRE(sent);
+    REQUIRE(sent->meta.transfer_id == 0xCAFE'CAFE);
+    REQUIRE(sent->payload_len == 200);
+}
+
+TEST_CASE("kocherga_serial::SerialNode request deduplication")
+{
+    using kocherga::serial::detail::Transfer;
+    SerialPortMock               port;
+    kocherga::serial::SerialNode node(port, {});
+    node.setLocalNodeID(2222);
+    ReactorMock reactor;
+
+    std::vector<std::pair<kocherga::NodeID, kocherga::TransferID>> accepted;
+    reactor.setIncomingRequestHandler(
+        [&accepted](const ReactorMock::IncomingRequest& ir) -> std::optional<std::vector<std::uint8_t>> {
+            accepted.emplace_back(ir.client_node_id, ir.data.at(0));
+            return {};
+        });
+    const auto push = [&port](const kocherga::NodeID source, const kocherga::TransferID transfer_id) {
+        Transfer request;
+        request.meta.source      = source;
+        request.meta.destination = 2222;
+        request.meta.data_spec   = static_cast<std::uint16_t>(kocherga::ServiceID::NodeExecuteCommand) |
+                                 static_cast<std::uint16_t>(Transfer::Metadata::DataSpecServiceFlag |
+                                                            Transfer::Metadata::DataSpecRequestFlag);
+        request.meta.transfer_id = transfer_id;
+        const auto payload_byte  = static_cast<std::uint8_t>(transfer_id);
+        request.payload_len      = 1;
+        request.payload          = &payload_byte;
+        port.pushRx(request);
+    };
+
+    // Redundant transmissions from two clients interleaved: (A, A, B, B, A) --> (A, B).
+    push(1000, 10);
+    push(1000, 10);
+    push(1001, 20);
+    push(1001, 20);
+    push(1000, 10);
+    push(1001, 20);
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+    REQUIRE(accepted == std::vector<std::pair<kocherga::NodeID, kocherga::TransferID>>{{1000, 10}, {1001, 20}});
+
+    // New transfers are accepted; their duplicates are not.
+    accepted.clear();
+    push(1000, 11);
+    push(1001, 21);
+    push(1000, 11);
+    push(1001, 21);
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+    REQUIRE(accepted == std::vector<std::pair<kocherga::NodeID, kocherga::TransferID>>{{1000, 11}, {1001, 21}});
+
+    // The same transfer-ID is accepted again after the transfer-ID timeout.
+    accepted.clear();
+    push(1000, 11);
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(10'000'000));
+    REQUIRE(accepted == std::vector<std::pair<kocherga::NodeID, kocherga::TransferID>>{{1000, 11}});
+}
+
+TEST_CASE("kocherga_serial::TransferIDTable")
+{
+    using kocherga::serial::detail::Transfer;
+    using kocherga::serial::detail::TransferIDTable;
+    using std::chrono::microseconds;
+
+    const auto meta = [](const kocherga::NodeID source, const kocherga::PortID data_spec, const std::uint64_t tid) {
+        Transfer::Metadata out{};
+        out.source      = source;
+        out.data_spec   = data_spec;
+        out.transfer_id = tid;
+        return out;
+    };
+    TransferIDTable<2> tbl;
+    REQUIRE(tbl.accept(meta(1, 100, 0), microseconds(10)));
+    REQUIRE(tbl.accept(meta(1, 101, 0), microseconds(20)));  // Different data specifier is a different session.
+    REQUIRE(!tbl.accept(meta(1, 100, 0), microseconds(30)));
+    REQUIRE(!tbl.accept(meta(1, 101, 0), microseconds(40)));
+    // The table is full; the least recently accepted session (1, 100) is evicted.
+    REQUIRE(tbl.accept(meta(2, 100, 0), microseconds(50)));
+    REQUIRE(!tbl.accept(meta(1, 101, 0), microseconds(60)));
+    REQUIRE(!tbl.accept(meta(2, 100, 0), microseconds(70)));
+    REQUIRE(tbl.accept(meta(1, 100, 0), microseconds(80)));  // Forgotten, hence accepted; evicts (1, 101).
+    REQUIRE(!tbl.accept(meta(2, 100, 0), microseconds(90)));
+    REQUIRE(tbl.accept(meta(1, 101, 0), microseconds(100)));
+}
+
+TEST_CASE("kocherga_serial::SerialNode TX queue")
+{
+    using kocherga::serial::detail::Transfer;
+    using kocherga::serial::detail::getMaxEncodedFrameSize;
+    static constexpr auto FrameSize = getMaxEncodedFrameSize(300);
+    using Node = kocherga::serial::BasicSerialNode<getMaxEncodedFrameSize(kocherga::MaxSerializedRepresentationSize) +
+                                                   (FrameSize * 2U)>;
+    BlockSerialPortMock port;
+    Node                node(port, {});
+    node.setLocalNodeID(2222);
+    ReactorMock reactor;
+    reactor.setIncomingRequestHandler([](const ReactorMock::IncomingRequest& ir) {
+        return std::vector<std::uint8_t>(300, ir.data.at(0));  // The response payload identifies the request.
+    });
+    const auto push = [&port](const std::uint8_t priority, const std::uint8_t tag) {
+        Transfer request;
+        request.meta.priority    = priority;
+        request.meta.source      = 1111;
+        request.meta.destination = 2222;
+        request.meta.data_spec   = static_cast<std::uint16_t>(kocherga::ServiceID::NodeExecuteCommand) |
+                                 static_cast<std::uint16_t>(Transfer::Metadata::DataSpecServiceFlag |
+                                                            Transfer::Metadata::DataSpecRequestFlag);
+        request.meta.transfer_id = tag;
+        request.payload_len      = 1;
+        request.payload          = &tag;
+        port.pushRx(request);
+    };
+    const auto pop_tags = [&port]() {
+        std::vector<std::uint8_t> out;
+        while (const auto tr = port.popTx())
+        {
+            out.push_back(tr->payload[0]);
+        }
+        return out;
+    };
+
+    // The port is blocked, so the responses accumulate in the TX queue of the node.
+    port.setTxCapacity(0);
+    push(6, 'A');
+    push(6, 'B');
+    push(6, 'C');
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+    // An urgent response evicts the oldest of the least urgent ones.
+    push(2, 'D');
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+    // A response that is less urgent than everything queued is dropped.
+    push(7, 'E');
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(3'000));
+    REQUIRE(pop_tags().empty());
+    port.setTxCapacity(std::numeric_limits<std::size_t>::max());
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(4'000));
+    REQUIRE(pop_tags() == std::vector<std::uint8_t>{'B', 'C', 'D'});
+
+    // A partially sent frame is resumed rather than dropped; the frames that are not sent in time are dropped.
+    port.setTxCapacity(100);
+    push(6, 'F');
+    push(6, 'G');
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(5'000));
+    REQUIRE(node.getTxQueueSize() > FrameSize);
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(5'000) + Node::TxTimeout * 2);
+    REQUIRE(node.getTxQueueSize() < FrameSize);
+    port.setTxCapacity(std::numeric_limits<std::size_t>::max());
+    static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(5'000) + Node::TxTimeout * 2);
+    REQUIRE(node.getTxQueueSize() == 0);
+    REQUIRE(pop_tags() == std::vector<std::uint8_t>{'F'});
+    REQUIRE(node.getStatistics().tx_frames_dropped == 3);  // A, E, G.
+}
+
+TEST_CASE("kocherga_serial::SerialNode RX budget")
+{
+    using kocherga::serial::detail::Transfer;
+    using Node = kocherga::serial::SerialNode;
+    const auto encode = [](const kocherga::NodeID destination, const std::uint8_t& tag) {
+        Transfer request;
+        request.meta.source      = 1111;
+        request.meta.destination = destination;
+        request.meta.data_spec   = static_cast<std::uint16_t>(kocherga::ServiceID::NodeExecuteCommand) |
+                                 static_cast<std::uint16_t>(Transfer::Metadata::DataSpecServiceFlag |
+                                                            Transfer::Metadata::DataSpecRequestFlag);
+        request.meta.transfer_id = tag;
+        request.payload_len      = 1;
+        request.payload          = &tag;
+        std::vector<std::uint8_t> out;
+        REQUIRE(kocherga::serial::detail::transmit(
+            [&out](const std::uint8_t bt) {
+                out.push_back(bt);
+                return true;
+            },
+            request));
+        return out;
+    };
+    const auto frame_size = encode(2222, 0).size();  // Including both delimiters.
+    std::vector<std::uint8_t> accepted;
+    ReactorMock               reactor;
+    reactor.setIncomingRequestHandler([&accepted](const ReactorMock::IncomingRequest& ir) {
+        accepted.push_back(ir.data.at(0));
+        return std::optional<std::vector<std::uint8_t>>{};
+    });
+
+    // Without the extension, the poll stops exactly at the budget, leaving the second frame incomplete.
+    {
+        BlockSerialPortMock port;
+        Node::Params        params;
+        params.rx_budget           = frame_size + (frame_size / 2);
+        params.rx_budget_extension = 0;
+        Node node(port, {}, params);
+        node.setLocalNodeID(2222);
+        for (std::uint8_t tag = 1; tag <= 3; tag++)
+        {
+            port.pushRx(encode(2222, tag));
+        }
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+        REQUIRE(accepted == std::vector<std::uint8_t>{1});
+        REQUIRE(port.getRxSize() == ((frame_size * 3) - (frame_size + (frame_size / 2))));
+        REQUIRE(node.getStatistics().rx_bytes == (frame_size + (frame_size / 2)));
+        REQUIRE(node.getStatistics().rx_frames_accepted == 1);
+        REQUIRE(node.getStatistics().rx_budget_exhausted == 1);
+        // The unread data may not wake up a tickless host, so the node asks to be polled again right away.
+        REQUIRE(static_cast<kocherga::INode&>(node).getNextDeadline() == std::chrono::microseconds(1'000));
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+        REQUIRE(accepted == std::vector<std::uint8_t>{1, 2, 3});
+        REQUIRE(port.getRxSize() == 0);
+        // The rest of the data happened to fit the budget exactly, so the node cannot tell that it is drained yet.
+        REQUIRE(static_cast<kocherga::INode&>(node).getNextDeadline() == std::chrono::microseconds(2'000));
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(3'000));
+        REQUIRE(!static_cast<kocherga::INode&>(node).getNextDeadline());  // Drained; wait for the data.
+        REQUIRE(node.getStatistics().rx_bytes == (frame_size * 3));
+        REQUIRE(node.getStatistics().rx_frames_accepted == 3);
+        REQUIRE(node.getStatistics().rx_bytes_dropped == 0);
+    }
+
+    // With the extension, the frame that is being received when the budget runs out is completed in the same poll.
+    accepted.clear();
+    {
+        BlockSerialPortMock port;
+        Node::Params        params;
+        params.rx_budget           = frame_size + (frame_size / 2);
+        params.rx_budget_extension = frame_size;
+        Node node(port, {}, params);
+        node.setLocalNodeID(2222);
+        for (std::uint8_t tag = 1; tag <= 3; tag++)
+        {
+            port.pushRx(encode(2222, tag));
+        }
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+        REQUIRE(accepted == std::vector<std::uint8_t>{1, 2});
+        REQUIRE(node.getStatistics().rx_bytes == ((frame_size * 2) + (frame_size / 2)));
+        REQUIRE(node.getStatistics().rx_budget_exhausted == 1);
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(2'000));
+        REQUIRE(accepted == std::vector<std::uint8_t>{1, 2, 3});
+    }
+
+    // Noise and the frames addressed to other nodes are accounted for as dropped; the delimiters are not counted.
+    accepted.clear();
+    {
+        BlockSerialPortMock port;
+        Node                node(port, {});
+        node.setLocalNodeID(2222);
+        port.pushRx(std::vector<std::uint8_t>(100, 0xAA));
+        port.pushRx(encode(3333, 1));
+        port.pushRx(encode(2222, 2));
+        static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+        REQUIRE(accepted == std::vector<std::uint8_t>{2});
+        const auto stats = node.getStatistics();
+        REQUIRE(stats.rx_bytes == (100 + (frame_size * 2)));
+        REQUIRE(stats.rx_frames_accepted == 1);
+        REQUIRE(stats.rx_bytes_dropped == (100 + (frame_size - 2)));
+        REQUIRE(stats.rx_budget_exhausted == 0);
+        REQUIRE(stats.tx_frames_dropped == 0);
+    }
+}
+
+TEST_CASE("kocherga_serial::SerialNode FEC over a lossy link")
+{
+    using kocherga::serial::detail::Transfer;
+    using Node = kocherga::serial::SerialNode;
+    static constexpr std::size_t      ExchangeCount = 300;
+    static constexpr std::size_t      ChunkSize     = 256;
+    static constexpr double           BitErrorRate  = 1e-4;
+    static constexpr double           BitRate       = 115'200.0 * 0.8;  // 8N1
+    static constexpr kocherga::NodeID ClientNodeID  = 20;
+    static constexpr kocherga::NodeID ServerNodeID  = 10;
+
+    std::mt19937 rng(42);  // NOLINT the sequence shall be reproducible
+    const auto   corrupt = [&rng](std::vector<std::uint8_t>& buf) {
+        std::bernoulli_distribution flip(BitErrorRate);
+        for (auto& x : buf)
+        {
+            for (auto bit = 0U; bit < 8U; bit++)
+            {
+                x = static_cast<std::uint8_t>(x ^ (flip(rng) ? (1U << bit) : 0U));
+            }
+        }
+    };
+
+    // The node reads a file chunk by chunk from a stand-in for the file server over a link that damages the data
+    // in both directions. A lost chunk costs a response timeout, after which the bootloader would request it again.
+    std::array<double, 2> throughput{};
+    for (const bool fec : {false, true})
+    {
+        BlockSerialPortMock port;
+        Node::Params        params;
+        params.fec = fec;
+        Node node(port, {}, params);
+        node.setLocalNodeID(ClientNodeID);
+        ReactorMock                                                                            reactor;
+        kocherga::serial::detail::BlockStreamParser<kocherga::MaxSerializedRepresentationSize> server;
+        std::size_t                                                                            delivered  = 0;
+        std::size_t                                                                            wire_bytes = 0;
+        std::chrono::microseconds                                                              timeouts{0};
+        for (std::size_t k = 0; k < ExchangeCount; k++)
+        {
+            const std::array<std::uint8_t, 13> request{static_cast<std::uint8_t>(k)};  // Offset and path.
+            REQUIRE(static_cast<kocherga::INode&>(node).sendRequest(kocherga::ServiceID::FileRead,
+                                                                    ServerNodeID,
+                                                                    k,
+                                                                    request.size(),
+                                                                    request.data()));
+            auto tx = port.popTxRaw();
+            wire_bytes += tx.size();
+            corrupt(tx);
+            std::optional<Transfer::Metadata> received_request;
+            server.update(tx.data(), tx.size(), [&received_request](const Transfer& tr) {
+                received_request = tr.meta;
+            });
+            std::vector<std::uint8_t> chunk(ChunkSize);
+            std::iota(chunk.begin(), chunk.end(), static_cast<std::uint8_t>(k));
+            if (received_request)
+            {
+                Transfer response;
+                response.meta.source      = ServerNodeID;
+                response.meta.destination = received_request->source;
+                response.meta.data_spec   = static_cast<std::uint16_t>(received_request->data_spec &
+                                                                     ~Transfer::Metadata::DataSpecRequestFlag);
+                response.meta.transfer_id = received_request->transfer_id;
+                response.meta.fec         = received_request->fec;  // The response mirrors the request.
+                response.payload_len      = chunk.size();
+                response.payload          = chunk.data();
+                std::vector<std::uint8_t> rx;
+                REQUIRE(kocherga::serial::detail::transmit(
+                    [&rx](const std::uint8_t bt) {
+                        rx.push_back(bt);
+                        return true;
+                    },
+                    response));
+                wire_bytes += rx.size();
+                corrupt(rx);
+                port.pushRx(rx);
+            }
+            static_cast<kocherga::INode&>(node).poll(reactor, std::chrono::microseconds(1'000));
+            if (const auto resp = reactor.popPendingResponse())
+            {
+                REQUIRE(*resp == chunk);
+                delivered += chunk.size();
+            }
+            else
+            {
+                static_cast<kocherga::INode&>(node).cancelRequest();
+                timeouts += kocherga::ServiceResponseTimeout;
+            }
+        }
+        const auto elapsed =
+            (static_cast<double>(wire_bytes * 8U) / BitRate) + std::chrono::duration<double>(timeouts).count();
+        throughput.at(fec ? 1U : 0U) = static_cast<double>(delivered) / elapsed;
+        std::cout << "Lossy link, BER " << BitErrorRate << ", FEC " << (fec ? "on" : "off") << ": delivered "
+                  << (delivered / ChunkSize) << " of " << ExchangeCount << " chunks, "
+                  << node.getStatistics().rx_frames_corrected << " corrected; " << throughput.at(fec ? 1U : 0U)
+                  << " B/s" << std::endl;
+        REQUIRE((node.getStatistics().rx_frames_corrected > 0) == fec);
+    }
+    REQUIRE(throughput.at(1) > (throughput.at(0) * 2.0));
+
+    // FEC is enabled on the remote side only: the response mirrors the request, and the subsequent requests to that
+    // node are protected as well. The messages and the requests to the other nodes are unaffected.
+    BlockSerialPortMock port;
+    Node                node(port, {});
+    node.setLocalNodeID(ServerNodeID);
+    ReactorMock reactor;
+    reactor.setIncomingRequestHandler([](const ReactorMock::IncomingRequest&) {  //
+        return std::vector<std::uint8_t>{1, 2, 3};
+    });
+    auto& inode = static_cast<kocherga::INode&>(node);
+    REQUIRE(inode.sendRequest(kocherga::ServiceID::FileRead, ClientNodeID, 0, 0, nullptr));
+    REQUIRE(!port.popTx()->meta.fec);
+    inode.cancelRequest();
+    Transfer request;
+    request.meta.source      = ClientNodeID;
+    request.meta.destination = ServerNodeID;
+    request.meta.data_spec   = static_cast<std::uint16_t>(kocherga::ServiceID::NodeExecuteCommand) |
+                             static_cast<std::uint16_t>(Transfer::Metadata::DataSpecServiceFlag |
+                                                        Transfer::Metadata::DataSpecRequestFlag);
+    request.meta.transfer_id = 7;
+    request.meta.fec         = true;
+    port.pushRx(request);
+    inode.poll(reactor, std::chrono::microseconds(1'000));
+    const auto response = port.popTx();
+    REQUIRE(response);
+    REQUIRE(response->meta.fec);
+    REQUIRE(response->meta.transfer_id == 7);
+    REQUIRE(inode.sendRequest(kocherga::ServiceID::FileRead, ClientNodeID, 1, 0, nullptr));
+    REQUIRE(port.popTx()->meta.fec);
+    inode.cancelRequest();
+    REQUIRE(inode.sendRequest(kocherga::ServiceID::FileRead, ClientNodeID + 1U, 2, 0, nullptr));
+    REQUIRE(!port.popTx()->meta.fec);
+    inode.cancelRequest();
+    REQUIRE(inode.publishMessage(kocherga::SubjectID::NodeHeartbeat, 0, 0, nullptr));
+    REQUIRE(!port.popTx()->meta.fec);
+    // Once the remote node stops using FEC, so does the local node.
+    request.meta.transfer_id = 8;
+    request.meta.fec         = false;
+    port.pushRx(request);
+    inode.poll(reactor, std::chrono::microseconds(2'000));
+    REQUIRE(!port.popTx()->meta.fec);
+    REQUIRE(inode.sendRequest(kocherga::ServiceID::FileRead, ClientNodeID, 3, 0, nullptr));
+    REQUIRE(!port.popTx()->meta.fec);
+}
+
+TEST_CASE("kocherga_serial::SerialNode PnP")
+{
+    using kocherga::serial::detail::Transfer;
+    using kocherga::detail::dsdl::PnPNodeIDAllocation;
+    using std::chrono::microseconds;
+    using Node = kocherga::serial::SerialNode;
+    static constexpr auto PnPSubjectID = static_cast<kocherga::PortID>(kocherga::SubjectID::PnPNodeIDAllocationData_v2);
+
+    kocherga::SystemInfo::UniqueID uid{};
+    std::iota(uid.begin(), uid.end(), static_cast<std::uint8_t>(100));
+    ReactorMock reactor;
+
+    // By default, there is no preferred node-ID and the requests are spaced by up to the maximum interval.
+    {
+        SerialPortMock port;
+        Node           node(port, uid);
+        static_cast<kocherga::INode&>(node).poll(reactor, microseconds(0));
+        const auto request = port.popTx();
+        REQUIRE(request);
+        REQUIRE(request->meta.data_spec == PnPSubjectID);
+        REQUIRE(request->payload_len == PnPNodeIDAllocation::MessageSize_v2);
+        REQUIRE(request->payload[0] == 0xFF);
+        REQUIRE(request->payload[1] == 0xFF);
+        REQUIRE(std::equal(uid.begin(), uid.end(), request->payload + 2));
+        REQUIRE(*static_cast<kocherga::INode&>(node).getNextDeadline() <= PnPNodeIDAllocation::MaxRequestInterval);
+    }
+
+    // A zero or negative initial interval is raised to the minimum instead of flooding the bus with requests.
+    for (const auto initial : {microseconds(0), microseconds(-1'000)})
+    {
+        SerialPortMock port;
+        Node::Params   params;
+        params.pnp_initial_request_interval = initial;
+        Node        node(port, uid, params);
+        std::size_t count = 0;
+        for (microseconds ts{0}; ts < microseconds(100'000); ts += microseconds(10))
+        {
+            static_cast<kocherga::INode&>(node).poll(reactor, ts);
+            while (port.popTx())
+            {
+                count++;
+            }
+        }
+        REQUIRE(count >= 2);
+        REQUIRE(count <= 20);  // Intervals of up to 1, 2, 4, ... ms; unbounded if the interval stayed at zero.
+    }
+
+    SerialPortMock port;
+    Node::Params   params;
+    params.pnp_preferred_node_id        = 1234;
+    params.pnp_initial_request_interval = microseconds(20'000);
+    Node node(port, uid, params);
+    REQUIRE(!node.getLocalNodeID());
+
+    // The intervals double from the initial value up to the maximum.
+    std::vector<microseconds> request_times;
+    for (microseconds ts{0}; ts < microseconds(10'000'000); ts += microseconds(1'000))
+    {
+        static_cast<kocherga::INode&>(node).poll(reactor, ts);
+        while (const auto request = port.popTx())
+        {
+            REQUIRE(request->meta.source == Transfer::Metadata::AnonymousNodeID);
+            REQUIRE(request->meta.data_spec == PnPSubjectID);
+            REQUIRE(request->payload[0] == (1234U & 0xFFU));
+            REQUIRE(request->payload[1] == (1234U >> 8U));
+            REQUIRE(std::equal(uid.begin(), uid.end(), request->payload + 2));
+            request_times.push_back(ts);
+        }
+    }
+    REQUIRE(request_times.size() >= 9);  // 20, 40, ..., 1280 ms, then 2 s.
+    auto bound = microseconds(20'000);
+    for (std::size_t i = 1; i < request_times.size(); i++)
+    {
+        REQUIRE((request_times.at(i) - request_times.at(i - 1U)) <= (bound + microseconds(1'000)));
+        bound = std::min<microseconds>(bound * 2, PnPNodeIDAllocation::MaxRequestInterval);
+    }
+    REQUIRE(request_times.at(2) <= microseconds(62'000));
+
+    // The allocator grants the preferred node-ID; the node exposes it so that it can be persisted.
+    std::array<std::uint8_t, PnPNodeIDAllocation::MessageSize_v2> payload{};
+    payload.at(0) = static_cast<std::uint8_t>(1234U & 0xFFU);
+    payload.at(1) = static_cast<std::uint8_t>(1234U >> 8U);
+    std::copy(uid.begin(), uid.end(), &payload.at(2));
+    Transfer response;
+    response.meta.source      = 1;
+    response.meta.data_spec   = PnPSubjectID;
+    response.meta.transfer_id = 0;
+    response.payload_len      = payload.size();
+    response.payload          = payload.data();
+    port.pushRx(response);
+    static_cast<kocherga::INode&>(node).poll(reactor, microseconds(10'000'000));
+    REQUIRE(node.getLocalNodeID() == 1234);
+    REQUIRE(!static_cast<kocherga::INode&>(node).getNextDeadline());
+    REQUIRE(!port.popTx());
+}
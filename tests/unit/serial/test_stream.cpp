@@ -5,6 +5,7 @@
 #include "kocherga_serial.hpp"  // NOLINT include order: include Kocherga first to ensure no headers are missed.
 #include "util.hpp"             // NOLINT include order
 #include "catch.hpp"
+#include <chrono>
 #include <iostream>
 #include <numeric>
 
@@ -90,6 +91,123 @@ TEST_CASE("serial::COBSEncoder")
     }
 }
 
+TEST_CASE("serial::COBSBlockEncoder")
+{
+    using kocherga::serial::detail::COBSBlockEncoder;
+    using kocherga::serial::detail::COBSEncoder;
+    using Buf   = std::vector<std::uint8_t>;
+    using Clock = std::chrono::steady_clock;
+
+    static const auto encode_bytes = [](const Buf& in) {
+        Buf         out;
+        COBSEncoder enc([&out](const std::uint8_t x) {
+            out.push_back(x);
+            return true;
+        });
+        for (const auto x : in)
+        {
+            REQUIRE(enc.push(x));
+        }
+        REQUIRE(enc.end());
+        return out;
+    };
+    // The input is split into fragments of random size, as is done when the header and the payload are pushed.
+    static const auto encode_blocks = [](const Buf& in, const std::size_t max_fragment) {
+        Buf              out;
+        COBSBlockEncoder enc([&out](const std::uint8_t* const data, const std::size_t size) {
+            out.insert(out.end(), data, data + size);
+            return true;
+        });
+        std::size_t offset = 0;
+        while (offset < in.size())
+        {
+            const auto size = std::min(in.size() - offset, (util::getRandomInteger<std::size_t>() % max_fragment) + 1U);
+            REQUIRE(enc.push(in.data() + offset, size));
+            offset += size;
+        }
+        REQUIRE(enc.end());
+        return out;
+    };
+
+    // Differential test against the byte-oriented encoder; the inputs range from zero-free to mostly zeros.
+    for (auto i = 0U; i < 3'000U; i++)
+    {
+        Buf        in(util::getRandomInteger<std::uint16_t>() % 2'000U);
+        const auto zero_probability = util::getRandomInteger<std::uint8_t>();
+        for (auto& x : in)
+        {
+            x = (util::getRandomInteger<std::uint8_t>() < zero_probability)
+                    ? 0
+                    : static_cast<std::uint8_t>((util::getRandomInteger<std::uint8_t>() % 255U) + 1U);
+        }
+        REQUIRE(encode_blocks(in, (i % 2U) == 0 ? in.size() + 1U : 300U) == encode_bytes(in));
+    }
+    // Edge cases around the maximum run length.
+    for (const auto size : {0U, 253U, 254U, 255U, 508U, 509U})
+    {
+        for (const auto trailing_zero : {false, true})
+        {
+            Buf in(size, 0x55);
+            if (trailing_zero)
+            {
+                in.push_back(0);
+            }
+            REQUIRE(encode_blocks(in, 1) == encode_bytes(in));
+            REQUIRE(encode_blocks(in, 1000) == encode_bytes(in));
+        }
+    }
+
+    // The failure of the writer is propagated.
+    {
+        std::size_t      calls = 0;
+        COBSBlockEncoder enc([&calls](const std::uint8_t* const, const std::size_t) { return ++calls < 3; });
+        const Buf        in{1, 2, 0, 3, 4, 0, 5};
+        REQUIRE(!enc.push(in.data(), in.size()));
+        REQUIRE(calls == 3);
+    }
+
+    // Encoding a 300-byte payload: one callback per byte versus one per run.
+    Buf payload(300);
+    for (auto& x : payload)
+    {
+        x = util::getRandomInteger<std::uint8_t>();
+    }
+    static constexpr std::size_t Repetitions = 10'000;
+    std::size_t                  sink        = 0;
+    bool                         ok          = true;
+    auto                         started     = Clock::now();
+    for (auto rep = 0U; rep < Repetitions; rep++)
+    {
+        COBSEncoder enc([&sink](const std::uint8_t x) {
+            sink += x;
+            return true;
+        });
+        for (const auto x : payload)
+        {
+            ok = enc.push(x) && ok;
+        }
+        ok = enc.end() && ok;
+    }
+    const auto byte_time = Clock::now() - started;
+    started              = Clock::now();
+    for (auto rep = 0U; rep < Repetitions; rep++)
+    {
+        COBSBlockEncoder enc([&sink](const std::uint8_t* const data, const std::size_t size) {
+            sink += data[size - 1U];
+            return true;
+        });
+        ok = enc.push(payload.data(), payload.size()) && enc.end() && ok;
+    }
+    const auto block_time   = Clock::now() - started;
+    REQUIRE(ok);
+    const auto ns_per_frame = [](const Clock::duration d) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+               static_cast<double>(Repetitions);
+    };
+    std::cout << "COBS 300 bytes: byte-wise " << ns_per_frame(byte_time) << " ns/frame; "
+              << "block " << ns_per_frame(block_time) << " ns/frame (checksum " << sink << ")" << std::endl;
+}
+
 TEST_CASE("serial::transmit")
 {
     using kocherga::serial::detail::transmit;
@@ -182,6 +300,38 @@ TEST_CASE("serial::transmit")
         REQUIRE(reference == history);
     }
 
+    // Same as above, but the payload CRC is supplied by the caller, as done when a request is retransmitted.
+    // The header is encoded anew; the supplied payload CRC is used as-is.
+    {
+        kocherga::detail::CRC32C crc;
+        crc.update(3, reinterpret_cast<const std::uint8_t*>("\x00\x01\x02"));
+        Buf        history;
+        const auto make_transfer = [](const std::uint64_t transfer_id) {
+            return Transfer{
+                Transfer::Metadata{5, 1234, Transfer::Metadata::AnonymousNodeID, 2345, transfer_id},
+                3,
+                reinterpret_cast<const std::uint8_t*>("\x00\x01\x02"),
+            };
+        };
+        const auto push = [&history](const auto bt) {
+            history.push_back(bt);
+            return true;
+        };
+        REQUIRE(transmit(push, make_transfer(1111), crc));
+        REQUIRE(history == Buf{0x00, 0x0b, 0x01, 0x05, 0xd2, 0x04, 0xff, 0xff, 0x29, 0x09, 0x57, 0x04, 0x01,
+                               0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x02, 0x80, 0x01, 0x03, 0x4f, 0x83,
+                               0x07, 0x01, 0x02, 0xfa, 0x4b, 0xfd, 0x92, 0x00});
+        history.clear();
+        REQUIRE(transmit(push, make_transfer(1112)));
+        const Buf reference = history;
+        history.clear();
+        REQUIRE(transmit(push, make_transfer(1112), crc));
+        REQUIRE(reference == history);
+        history.clear();
+        REQUIRE(transmit(push, make_transfer(1112), kocherga::detail::CRC32C{}));
+        REQUIRE(reference != history);  // The payload is not looked at.
+    }
+
     // Failure case
     {
         std::array<std::uint8_t, 300> buf{};
@@ -666,3 +816,383 @@ TEST_CASE("serial::StreamParser error")
         REQUIRE(!tr);
     }
 }
+
+TEST_CASE("serial::BlockStreamParser")
+{
+    using kocherga::serial::detail::BlockStreamParser;
+    using kocherga::serial::detail::StreamParser;
+    using kocherga::serial::detail::transmit;
+    using kocherga::serial::detail::Transfer;
+    using Buf   = std::vector<std::uint8_t>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Received
+    {
+        Transfer::Metadata meta;
+        Buf                payload;
+
+        [[nodiscard]] auto operator==(const Received& rhs) const -> bool
+        {
+            return (meta.priority == rhs.meta.priority) && (meta.source == rhs.meta.source) &&
+                   (meta.destination == rhs.meta.destination) && (meta.data_spec == rhs.meta.data_spec) &&
+                   (meta.transfer_id == rhs.meta.transfer_id) && (meta.fec == rhs.meta.fec) &&
+                   (payload == rhs.payload);
+        }
+    };
+    static constexpr std::size_t MaxPayloadSize = 100;
+
+    // A stream of valid, invalid, oversized, and corrupted frames interleaved with garbage.
+    Buf stream;
+    for (auto i = 0U; i < 2'000U; i++)
+    {
+        Buf payload(util::getRandomInteger<std::uint8_t>() % (MaxPayloadSize + 20U));
+        for (auto& x : payload)
+        {
+            x = (util::getRandomInteger<std::uint8_t>() < 32U) ? 0 : util::getRandomInteger<std::uint8_t>();
+        }
+        const auto kind = util::getRandomInteger<std::uint8_t>() % 3U;
+        Transfer   tr{};
+        tr.meta.priority    = static_cast<std::uint8_t>(util::getRandomInteger<std::uint8_t>() % 8U);
+        tr.meta.source      = static_cast<std::uint16_t>(i % 1000U);
+        tr.meta.destination = static_cast<std::uint16_t>(i % 999U);
+        if (kind == 0U)  // Message
+        {
+            tr.meta.destination = Transfer::Metadata::AnonymousNodeID;
+        }
+        if (kind == 2U)  // Anonymous service transfer, which is invalid
+        {
+            tr.meta.source = Transfer::Metadata::AnonymousNodeID;
+        }
+        tr.meta.data_spec   = static_cast<std::uint16_t>((kind == 0U) ? (i % 8192U) : (0xC000U | (i % 512U)));
+        tr.meta.transfer_id = (static_cast<std::uint64_t>(i) << 32U) | i;
+        tr.meta.fec         = (util::getRandomInteger<std::uint8_t>() % 2U) == 0U;
+        tr.payload_len      = payload.size();
+        tr.payload          = payload.data();
+        const auto frame_at = stream.size();
+        REQUIRE(transmit(
+            [&stream](const std::uint8_t x) {
+                stream.push_back(x);
+                return true;
+            },
+            tr));
+        if (util::getRandomInteger<std::uint8_t>() < 32U)  // Corrupt a random byte.
+        {
+            const auto index = frame_at + (util::getRandomInteger<std::uint16_t>() % (stream.size() - frame_at));
+            stream.at(index) = util::getRandomInteger<std::uint8_t>();
+        }
+        if (util::getRandomInteger<std::uint8_t>() < 16U)  // Inject garbage.
+        {
+            for (auto k = util::getRandomInteger<std::uint8_t>(); k > 0; k--)
+            {
+                stream.push_back(util::getRandomInteger<std::uint8_t>());
+            }
+        }
+    }
+
+    // Reference: the byte-oriented parser.
+    std::vector<Received>        reference;
+    StreamParser<MaxPayloadSize> sp;
+    for (const auto x : stream)
+    {
+        if (const auto tr = sp.update(x))
+        {
+            reference.push_back({tr->meta, Buf(tr->payload, tr->payload + tr->payload_len)});
+        }
+    }
+    REQUIRE(reference.size() > 100);
+
+    // The output shall not depend on how the stream is fragmented.
+    for (const std::size_t max_fragment : {std::size_t{1}, std::size_t{7}, std::size_t{300}, stream.size()})
+    {
+        std::vector<Received>             received;
+        BlockStreamParser<MaxPayloadSize> bsp;
+        const auto                        handler = [&received](const Transfer& tr) {
+            received.push_back({tr.meta, Buf(tr.payload, tr.payload + tr.payload_len)});
+        };
+        std::size_t offset = 0;
+        while (offset < stream.size())
+        {
+            const auto size = std::min<std::size_t>(stream.size() - offset,
+                                                    (util::getRandomInteger<std::uint16_t>() % max_fragment) + 1U);
+            bsp.update(stream.data() + offset, size, handler);
+            offset += size;
+        }
+        REQUIRE(received.size() == reference.size());
+        REQUIRE(received == reference);
+    }
+
+    // Throughput on a clean stream of large frames delivered in 256-byte blocks, as from a USB CDC endpoint.
+    stream.clear();
+    Buf                payload(256);
+    Transfer::Metadata meta{};
+    meta.source    = 1234;
+    meta.data_spec = 2345;
+    for (auto i = 0U; i < 1'000U; i++)
+    {
+        for (auto& x : payload)
+        {
+            x = util::getRandomInteger<std::uint8_t>();
+        }
+        REQUIRE(transmit(
+            [&stream](const std::uint8_t x) {
+                stream.push_back(x);
+                return true;
+            },
+            Transfer{meta, payload.size(), payload.data()}));
+    }
+    std::size_t                       byte_count = 0;
+    StreamParser<MaxPayloadSize * 3U> sp_large;
+    auto                              started = Clock::now();
+    for (const auto x : stream)
+    {
+        if (const auto tr = sp_large.update(x))
+        {
+            byte_count += tr->payload_len;
+        }
+    }
+    const auto                             byte_time   = Clock::now() - started;
+    std::size_t                            block_count = 0;
+    BlockStreamParser<MaxPayloadSize * 3U> bsp_large;
+    started = Clock::now();
+    for (std::size_t offset = 0; offset < stream.size(); offset += 256U)
+    {
+        bsp_large.update(stream.data() + offset,
+                         std::min<std::size_t>(256U, stream.size() - offset),
+                         [&block_count](const Transfer& tr) { block_count += tr.payload_len; });
+    }
+    const auto block_time = Clock::now() - started;
+    REQUIRE(byte_count == (payload.size() * 1'000U));
+    REQUIRE(block_count == byte_count);
+    const auto ns_per_byte = [&stream](const Clock::duration d) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) /
+               static_cast<double>(stream.size());
+    };
+    std::cout << "Stream parser: byte-wise " << ns_per_byte(byte_time) << " ns/byte; "
+              << "block " << ns_per_byte(block_time) << " ns/byte" << std::endl;
+}
+
+TEST_CASE("serial::BlockStreamParser filter")
+{
+    using kocherga::serial::detail::BlockStreamParser;
+    using kocherga::serial::detail::transmit;
+    using kocherga::serial::detail::Transfer;
+    using Buf = std::vector<std::uint8_t>;
+
+    // Requests addressed to nodes 40..44; some payloads exceed the capacity of the parser.
+    Buf stream;
+    for (auto i = 0U; i < 100U; i++)
+    {
+        const Buf payload((i % 3U == 0) ? 500U : 50U, static_cast<std::uint8_t>(i));
+        Transfer  tr{};
+        tr.meta.source      = 1;
+        tr.meta.destination = static_cast<std::uint16_t>(40U + (i % 5U));
+        tr.meta.data_spec   = 0xC000U | 123U;
+        tr.meta.transfer_id = i;
+        tr.payload_len      = payload.size();
+        tr.payload          = payload.data();
+        REQUIRE(transmit(
+            [&stream](const std::uint8_t x) {
+                stream.push_back(x);
+                return true;
+            },
+            tr));
+    }
+
+    BlockStreamParser<100>     bsp;
+    std::size_t                filter_calls = 0;
+    std::vector<std::uint64_t> received;
+    bsp.update(
+        stream.data(),
+        stream.size(),
+        [&filter_calls](const Transfer::Metadata& meta) {
+            filter_calls++;
+            return meta.destination == 42U;
+        },
+        [&received](const Transfer& tr) {
+            REQUIRE(tr.meta.destination == 42U);
+            REQUIRE(tr.payload_len == 50U);
+            REQUIRE(tr.payload[0] == static_cast<std::uint8_t>(tr.meta.transfer_id));
+            received.push_back(tr.meta.transfer_id);
+        });
+    REQUIRE(filter_calls == 100U);  // Once per frame, regardless of the payload size.
+    std::vector<std::uint64_t> expected;
+    for (auto i = 0U; i < 100U; i++)
+    {
+        if (((i % 5U) == 2U) && ((i % 3U) != 0))
+        {
+            expected.push_back(i);
+        }
+    }
+    REQUIRE(received == expected);
+
+    // Frames with an invalid header are rejected before the filter is consulted.
+    Transfer tr{};
+    tr.meta.data_spec = 0xC000U | 123U;  // Anonymous service request.
+    REQUIRE(transmit(
+        [&stream](const std::uint8_t x) {
+            stream.push_back(x);
+            return true;
+        },
+        tr));
+    filter_calls = 0;
+    bsp.update(
+        stream.data() + stream.size() - 40U,
+        40U,
+        [&filter_calls](const Transfer::Metadata&) {
+            filter_calls++;
+            return true;
+        },
+        [](const Transfer&) { FAIL("Unexpected transfer"); });
+    REQUIRE(filter_calls == 0);
+}
+
+TEST_CASE("serial::FEC")
+{
+    using kocherga::serial::detail::BlockStreamParser;
+    using kocherga::serial::detail::decodeFEC;
+    using kocherga::serial::detail::FECBlockSize;
+    using kocherga::serial::detail::FECEncoder;
+    using kocherga::serial::detail::getFECBodySize;
+    using kocherga::serial::detail::StreamParser;
+    using kocherga::serial::detail::transmit;
+    using kocherga::serial::detail::Transfer;
+    using Buf = std::vector<std::uint8_t>;
+
+    const auto encode = [](const Buf& body) {
+        Buf        out;
+        FECEncoder fec(
+            [&out](const std::uint8_t* const data, const std::size_t size) {
+                out.insert(out.end(), data, data + size);
+                return true;
+            },
+            body.size());
+        std::size_t offset = 0;  // The body is fragmented arbitrarily.
+        while (offset < body.size())
+        {
+            const auto size =
+                std::min<std::size_t>(body.size() - offset, (util::getRandomInteger<std::uint8_t>() % 70U) + 1U);
+            REQUIRE(fec.push(body.data() + offset, size));
+            offset += size;
+        }
+        REQUIRE(fec.end());
+        return out;
+    };
+    // A burst of up to 16 bits is always detected by the block CRC.
+    const auto damage = [](Buf& buf, const std::pair<std::size_t, std::size_t> span) {
+        const auto index = span.first + (util::getRandomInteger<std::uint16_t>() % (span.second - 1U));
+        buf.at(index) ^= static_cast<std::uint8_t>(util::getRandomInteger<std::uint8_t>() | 1U);
+        buf.at(index + 1U) ^= util::getRandomInteger<std::uint8_t>();
+    };
+
+    for (std::size_t n = 1; n <= 700; n++)
+    {
+        Buf body(n);
+        for (auto& x : body)
+        {
+            x = util::getRandomInteger<std::uint8_t>();
+        }
+        const auto enc = encode(body);
+        REQUIRE(enc.size() == getFECBodySize(n));
+        const auto check = [&body, n](Buf buf) {
+            const auto res = decodeFEC(buf.data(), buf.size());
+            REQUIRE(res);
+            REQUIRE(res->size == n);
+            REQUIRE(Buf(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n)) == body);
+            return res->corrected;
+        };
+        REQUIRE(!check(enc));
+
+        // The spans of the blocks with their CRCs; the parity block is the last one.
+        const auto block_count = (n + FECBlockSize - 1U) / FECBlockSize;
+        const auto span        = [n, block_count](const std::size_t index) {
+            const auto size = (index < block_count) ? std::min(FECBlockSize, n - (index * FECBlockSize))  //
+                                                           : std::min(n, FECBlockSize);
+            return std::make_pair(std::min(index * FECBlockSize, n) + (index * 2U), size + 2U);
+        };
+        for (std::size_t i = 0; i <= block_count; i++)
+        {
+            auto buf = enc;
+            damage(buf, span(i));
+            REQUIRE(check(buf) == (i < block_count));
+        }
+
+        // Damage to two blocks is detected.
+        const auto a = util::getRandomInteger<std::uint16_t>() % (block_count + 1U);
+        const auto b = (a + 1U + (util::getRandomInteger<std::uint16_t>() % block_count)) % (block_count + 1U);
+        REQUIRE(a != b);
+        auto buf = enc;
+        damage(buf, span(a));
+        damage(buf, span(b));
+        REQUIRE(!decodeFEC(buf.data(), buf.size()));
+    }
+
+    // Sizes that cannot be produced by the encoder are rejected.
+    for (const std::size_t size : {0U, 1U, 2U, 3U, 4U, 5U, 7U, 69U, 70U})
+    {
+        Buf buf(size);
+        REQUIRE(!decodeFEC(buf.data(), buf.size()));
+    }
+
+    // End-to-end: a damaged byte in the body costs the whole frame unless FEC is used.
+    Buf payload(256);
+    for (auto& x : payload)
+    {
+        x = util::getRandomInteger<std::uint8_t>();
+    }
+    for (const bool fec : {false, true})
+    {
+        Transfer tr{};
+        tr.meta.source      = 1234;
+        tr.meta.data_spec   = 2345;
+        tr.meta.transfer_id = 42;
+        tr.meta.fec         = fec;
+        tr.payload_len      = payload.size();
+        tr.payload          = payload.data();
+        Buf stream;
+        REQUIRE(transmit(
+            [&stream](const std::uint8_t x) {
+                stream.push_back(x);
+                return true;
+            },
+            tr));
+        // Damage a data byte in the middle of the body while keeping the COBS code bytes intact.
+        std::vector<bool> is_code(stream.size(), false);
+        for (std::size_t i = 1; i < (stream.size() - 1U); i += stream.at(i))
+        {
+            is_code.at(i) = true;
+        }
+        auto index = stream.size() / 2U;
+        while (is_code.at(index))
+        {
+            index++;
+        }
+        stream.at(index) = static_cast<std::uint8_t>(~stream.at(index));
+        if (stream.at(index) == 0)
+        {
+            stream.at(index) = 1;
+        }
+
+        std::size_t       sp_count = 0;
+        StreamParser<300> sp;
+        for (const auto x : stream)
+        {
+            if (const auto out = sp.update(x))
+            {
+                REQUIRE(out->meta.fec == fec);
+                REQUIRE(Buf(out->payload, out->payload + out->payload_len) == payload);
+                sp_count++;
+            }
+        }
+        std::size_t            bsp_count = 0;
+        BlockStreamParser<300> bsp;
+        bsp.update(stream.data(), stream.size(), [&](const Transfer& out) {
+            REQUIRE(out.meta.fec == fec);
+            REQUIRE(out.meta.transfer_id == 42);
+            REQUIRE(Buf(out.payload, out.payload + out.payload_len) == payload);
+            bsp_count++;
+        });
+        REQUIRE(sp_count == (fec ? 1U : 0U));
+        REQUIRE(bsp_count == (fec ? 1U : 0U));
+        REQUIRE(bsp.getCorrectedFrameCount() == (fec ? 1U : 0U));
+    }
+}
@@ -452,8 +452,13 @@ TEST_CASE("Bootloader-trigger")
     REQUIRE(bl.addNode(&nodes.at(2)));
     REQUIRE(!bl.addNode(&nodes.at(2)));  // Double registration has no effect.
 
+    REQUIRE(bl.getNextDeadline() == 0ms);  // Not polled yet.
     REQUIRE(!bl.poll(100ms));
     REQUIRE(bl.getState() == kocherga::State::BootDelay);
+    REQUIRE(bl.getNextDeadline() == 1s);  // The heartbeat precedes the end of the boot delay.
+    nodes.at(1).setNextDeadline(500ms);
+    REQUIRE(bl.getNextDeadline() == 500ms);
+    nodes.at(1).setNextDeadline({});
 
     auto ai = *bl.getAppInfo();
     REQUIRE(0x8B61'938E'E5F9'0B1FULL == ai.image_crc);
@@ -469,6 +474,7 @@ TEST_CASE("Bootloader-trigger")
     REQUIRE(bl.trigger(2, 2222, 69, path));
     REQUIRE(!bl.trigger(222, 2222, 69, path));  // No such node
     REQUIRE(bl.getState() == kocherga::State::AppUpdateInProgress);
+    REQUIRE(bl.getNextDeadline() == 100ms);  // The read request is to be sent at the next poll.
     REQUIRE(!bl.poll(1'100ms));
     REQUIRE(checkHeartbeat(nodes, 0, 1, Heartbeat::Health::Nominal, 1));
 
@@ -557,3 +563,68 @@ TEST_CASE("Bootloader-trigger")
     const mock::Node stray_node;
     REQUIRE(!bl.trigger(&stray_node, 0, 69, path));
 }
+
+TEST_CASE("Bootloader-static-nodes")
+{
+    using std::chrono_literals::operator""s;
+    using std::chrono_literals::operator""ms;
+    using mock::Node;
+
+    const auto sys = getSysInfo();
+    const auto img = util::getImagePath("good-le-3rd-entry-5.6.3333333333333333.8b61938ee5f90b1f.app.dirty.bin");
+    REQUIRE(std::filesystem::copy_file(img, "rom.img.tmp", std::filesystem::copy_options::overwrite_existing));
+    util::FileROMBackend rom("rom.img.tmp");
+
+    using Bootloader = kocherga::BasicBootloader<kocherga::StaticNodeSet<Node, Node>>;
+    Bootloader::Params params;
+    params.max_app_size = static_cast<std::size_t>(std::filesystem::file_size(img));
+    params.boot_delay   = 1s;
+    // The nodes are constructed in place from one argument tuple per node.
+    Bootloader bl(rom, sys, params, std::forward_as_tuple(), std::forward_as_tuple());
+    REQUIRE(bl.getNumberOfNodes() == 2);
+    auto& node_a = bl.getNodes().get<0>();
+    auto& node_b = bl.getNodes().get<1>();
+    REQUIRE(bl.getNodes().at(0) == &node_a);
+    REQUIRE(bl.getNodes().at(1) == &node_b);
+    REQUIRE(bl.getNodes().at(2) == nullptr);
+
+    REQUIRE(!bl.poll(100ms));
+    REQUIRE(bl.getState() == kocherga::State::BootDelay);
+    REQUIRE(node_a.getLastPollTime() == 100ms);
+    REQUIRE(node_b.getLastPollTime() == 100ms);
+
+    const auto* const path =
+        reinterpret_cast<const std::uint8_t*>("good-le-3rd-entry-5.6.3333333333333333.8b61938ee5f90b1f.app.dirty.bin");
+    REQUIRE(!bl.trigger(2, 2222, 69, path));  // No such node
+    REQUIRE(bl.trigger(&node_b, 2222, 69, path));
+    REQUIRE(bl.getState() == kocherga::State::AppUpdateInProgress);
+    REQUIRE(!bl.poll(1'100ms));
+    REQUIRE(node_a.popOutput(Node::Output::HeartbeatMessage));
+    REQUIRE(node_b.popOutput(Node::Output::HeartbeatMessage));
+    REQUIRE(!bl.poll(1'200ms));
+    REQUIRE(node_a.popOutput(Node::Output::LogRecordMessage));
+    REQUIRE(node_b.popOutput(Node::Output::LogRecordMessage));
+    REQUIRE(!node_a.popOutput(Node::Output::FileReadRequest));
+    REQUIRE(node_b.popOutput(Node::Output::FileReadRequest).value().remote_node_id == 2222);
+}
+
+TEST_CASE("Bootloader-node-capacity")
+{
+    const auto sys = getSysInfo();
+    const auto img = util::getImagePath("good-le-3rd-entry-5.6.3333333333333333.8b61938ee5f90b1f.app.dirty.bin");
+    REQUIRE(std::filesystem::copy_file(img, "rom.img.tmp", std::filesystem::copy_options::overwrite_existing));
+    util::FileROMBackend rom("rom.img.tmp");
+
+    using Bootloader = kocherga::BasicBootloader<kocherga::DynamicNodeSet<2>>;
+    std::array<mock::Node, 3> nodes;
+    Bootloader                bl(rom, sys, Bootloader::Params{});
+    REQUIRE(bl.getNumberOfNodes() == 0);
+    REQUIRE(!bl.addNode(nullptr));
+    REQUIRE(bl.addNode(&nodes.at(0)));
+    REQUIRE(!bl.addNode(&nodes.at(0)));  // Double registration has no effect.
+    REQUIRE(bl.addNode(&nodes.at(1)));
+    REQUIRE(!bl.addNode(&nodes.at(2)));  // Capacity exhausted.
+    REQUIRE(bl.getNumberOfNodes() == 2);
+    REQUIRE(bl.getNodes().at(1) == &nodes.at(1));
+    REQUIRE(bl.getNodes().at(2) == nullptr);
+}
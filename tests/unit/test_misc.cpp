@@ -84,6 +84,58 @@ TEST_CASE("serial::CRC32C")
     crc.update(0xE3U);
     REQUIRE(crc.isResidueCorrect());
     REQUIRE(0xB798'B438UL == (~crc.get()));
+
+    // The block update is equivalent to the single-byte one.
+    kocherga::detail::CRC32C block;
+    block.update(9, reinterpret_cast<const std::uint8_t*>("123456789"));
+    REQUIRE(0xE306'9283UL == block.get());
+    block = crc;
+    for (auto i = 0U; i < 1000U; i++)
+    {
+        const auto b = static_cast<std::uint8_t>(i * 37U);
+        crc.update(b);
+        block.update(1, &b);
+        REQUIRE(crc.get() == block.get());
+    }
+}
+
+TEST_CASE("ResponseCRCCache")
+{
+    class Reactor final : public kocherga::IReactor
+    {
+    public:
+        std::optional<std::uint32_t> tag;
+
+    private:
+        auto processRequest(const kocherga::PortID,
+                            const kocherga::NodeID,
+                            const std::size_t,
+                            const std::uint8_t* const,
+                            std::uint8_t* const) -> std::optional<std::size_t> override
+        {
+            return {};
+        }
+        void processResponse(const std::size_t, const std::uint8_t* const) override {}
+        auto getResponseBuffer() -> std::pair<std::size_t, std::uint8_t*> override { return {0, nullptr}; }
+        auto getLastResponseTag() const -> std::optional<std::uint32_t> override { return tag; }
+    };
+    const auto* const a = reinterpret_cast<const std::uint8_t*>("123456789");  // NOSONAR NOLINT reinterpret_cast
+    const auto* const b = reinterpret_cast<const std::uint8_t*>("987654321");  // NOSONAR NOLINT reinterpret_cast
+
+    Reactor                                                      reactor;
+    kocherga::detail::ResponseCRCCache<kocherga::detail::CRC32C> cache;
+    REQUIRE(!cache.update(reactor, 430, 9, a));  // Not cached by the reactor.
+    reactor.tag = 1;
+    REQUIRE(cache.update(reactor, 430, 9, a)->get() == 0xE306'9283UL);
+    // The payload is not looked at while the tag and the service-ID are the same.
+    REQUIRE(cache.update(reactor, 430, 9, b)->get() == 0xE306'9283UL);
+    REQUIRE(cache.update(reactor, 430, 9, b)->get() == 0xE306'9283UL);
+    // A different tag or service-ID invalidates the entry.
+    reactor.tag = 2;
+    REQUIRE(cache.update(reactor, 430, 9, b)->get() != 0xE306'9283UL);
+    REQUIRE(cache.update(reactor, 435, 9, a)->get() == 0xE306'9283UL);
+    reactor.tag.reset();
+    REQUIRE(!cache.update(reactor, 435, 9, a));
 }
 
 TEST_CASE("VolatileStorage")
@@ -143,3 +195,50 @@ TEST_CASE("VolatileStorage")
     REQUIRE(std::all_of(arena.begin(), arena.end(), [](auto x) { return x == 0xCAU; }));
     REQUIRE(!marshaller.take());
 }
+
+TEST_CASE("LogQueue")
+{
+    using Severity = kocherga::detail::dsdl::Diagnostic::Severity;
+    kocherga::detail::LogQueue<3> q;
+    REQUIRE(q.front() == nullptr);
+    q.pop();  // No effect.
+    REQUIRE(q.size() == 0);
+
+    // Repeated records are coalesced regardless of the pointer identity; different severity is a different record.
+    const std::string again("Timeout");
+    q.push(Severity::Warning, "Timeout");
+    q.push(Severity::Warning, again.c_str());
+    q.push(Severity::Notice, "Timeout");
+    q.push(Severity::Warning, "Timeout");
+    REQUIRE(q.size() == 2);
+    REQUIRE(q.front()->severity == Severity::Warning);
+    REQUIRE(std::string(q.front()->text) == "Timeout");
+    REQUIRE(q.front()->count == 3);
+
+    // When full, the oldest of the least severe records is evicted, unless the new one is even less severe.
+    q.push(Severity::Notice, "A");
+    REQUIRE(q.size() == 3);
+    q.push(Severity::Critical, "B");  // Evicts (Notice, "Timeout").
+    REQUIRE(q.size() == 3);
+    q.push(Severity::Notice, "C");  // Evicts (Notice, "A").
+    q.push(Severity::Notice, "C");
+    q.push(Severity::Warning, "D");  // Evicts (Notice, "C").
+    REQUIRE(q.size() == 3);
+
+    REQUIRE(std::string(q.front()->text) == "Timeout");
+    q.pop();
+    REQUIRE(std::string(q.front()->text) == "B");
+    REQUIRE(q.front()->count == 1);
+    q.pop();
+    q.push(Severity::Critical, "E");
+    q.push(Severity::Critical, "F");
+    q.push(Severity::Notice, "G");  // Dropped: everything else is more severe.
+    REQUIRE(q.size() == 3);
+    REQUIRE(std::string(q.front()->text) == "D");
+    q.pop();
+    REQUIRE(std::string(q.front()->text) == "E");
+    q.pop();
+    REQUIRE(std::string(q.front()->text) == "F");
+    q.pop();
+    REQUIRE(q.front() == nullptr);
+}
@@ -122,7 +122,7 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
     // list(b''.join(pycyphal.dsdl.serialize(uavcan.diagnostic.Record_1_1(
     //      severity=uavcan.diagnostic.Severity_1_0(uavcan.diagnostic.Severity_1_0.NOTICE),
     //      text='Hello world!'))))
-    pres.publishLogRecord(kocherga::detail::dsdl::Diagnostic::Severity::Notice, "Hello world!");
+    REQUIRE(pres.publishLogRecord(kocherga::detail::dsdl::Diagnostic::Severity::Notice, "Hello world!"));
     for (auto& n : nodes)
     {
         const auto tr = *n.popOutput(Node::Output::LogRecordMessage);
@@ -134,7 +134,7 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
     // list(b''.join(pycyphal.dsdl.serialize(uavcan.diagnostic.Record_1_1(
     //      severity=uavcan.diagnostic.Severity_1_0(uavcan.diagnostic.Severity_1_0.CRITICAL),
     //      text='We are going to die :)'))))
-    pres.publishLogRecord(kocherga::detail::dsdl::Diagnostic::Severity::Critical, "We are going to die :)");
+    REQUIRE(pres.publishLogRecord(kocherga::detail::dsdl::Diagnostic::Severity::Critical, "We are going to die :)"));
     for (auto& n : nodes)
     {
         const auto tr = *n.popOutput(Node::Output::LogRecordMessage);
@@ -249,6 +249,13 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
         0xDEAD'DEAD'DEAD'DEADULL,
         {},
     });
+    // The response is cached, so it is not updated until invalidated.
+    nodes.at(1).pushInput(Node::Input::NodeInfoRequest, Transfer(665, std::vector<std::uint8_t>{}, 1111));
+    pres.poll(std::chrono::microseconds{1'905'000});
+    REQUIRE(nodes.at(1).popOutput(Node::Output::NodeInfoResponse)->payload.at(4) == 0);  // No software version.
+    const auto node_info_tag = static_cast<kocherga::IReactor&>(pres).getLastResponseTag();
+    REQUIRE(node_info_tag);  // The nodes may reuse the transfer CRC of the cached response.
+    pres.invalidateNodeInfo();
     nodes.at(1).pushInput(Node::Input::NodeInfoRequest, Transfer(666, std::vector<std::uint8_t>{}, 1111));
     ts = std::chrono::microseconds{1'910'000};
     pres.poll(ts);
@@ -280,6 +287,8 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
                                        1111);
     const auto     node_info_response = *nodes.at(1).popOutput(Node::Output::NodeInfoResponse);
     REQUIRE(node_info_reference == node_info_response);
+    REQUIRE(static_cast<kocherga::IReactor&>(pres).getLastResponseTag());
+    REQUIRE(static_cast<kocherga::IReactor&>(pres).getLastResponseTag() != node_info_tag);
 
     // It's time for another heartbeat.
     pres.setNodeHealth(kocherga::detail::dsdl::Heartbeat::Health::Warning);
@@ -390,6 +399,8 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
                      {64,  226, 1,  0,  0,   20, 47, 102, 111, 111, 47, 98,  97,
                       114, 47,  98, 97, 122, 46, 97, 112, 112, 46,  98, 105, 110},
                      3210));
+    REQUIRE(nodes.at(1).popResendCount() == 1);  // The retry reuses the serialized request.
+    REQUIRE(nodes.at(0).popResendCount() == 0);
     REQUIRE(!controller.popFileReadResult());
     REQUIRE(!nodes.at(0).wasRequestCanceled());
     REQUIRE(!nodes.at(1).wasRequestCanceled());  // Not yet!
@@ -404,3 +415,70 @@ TEST_CASE("Presenter")  // NOLINT NOSONAR complexity threshold
     REQUIRE(!nodes.at(0).wasRequestCanceled());
     REQUIRE(nodes.at(1).wasRequestCanceled());  // Given up.
 }
+
+TEST_CASE("Presenter log rate limiting")
+{
+    using mock::Node;
+    using Severity = kocherga::detail::dsdl::Diagnostic::Severity;
+
+    const kocherga::SystemInfo sys_info{
+        kocherga::SemanticVersion{33, 11},
+        {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16},
+        "com.zubax.kocherga.test.presenter",
+        0,
+        nullptr,
+    };
+    MockController                      controller;
+    Node                                node;
+    kocherga::detail::Presenter::Params params{};
+    params.request_retry_limit = 1;
+    params.log_bandwidth       = 100;  // Bytes per second.
+    kocherga::detail::Presenter pres(sys_info, controller, params);
+    REQUIRE(pres.addNode(&node));
+    const auto text_of = [](const mock::Transfer& tr) {
+        return std::string(tr.payload.begin() + 9, tr.payload.end());  // NOLINT
+    };
+
+    // The bucket is full initially; it holds one longest record (257 bytes). Each of these records is 20 bytes long.
+    std::size_t count = 0;
+    while (pres.publishLogRecord(Severity::Notice, "Hello world"))
+    {
+        REQUIRE(text_of(*node.popOutput(Node::Output::LogRecordMessage)) == "Hello world");
+        count++;
+    }
+    REQUIRE(count == 12);
+    REQUIRE(!node.popOutput(Node::Output::LogRecordMessage));
+    REQUIRE(pres.getLogBudgetDeadline() == std::chrono::microseconds{2'400'000});  // 240 bytes to refill.
+    REQUIRE(pres.getNextDeadline() == std::chrono::microseconds{1'000'000});       // The first heartbeat.
+    node.setNextDeadline(std::chrono::microseconds{10});
+    REQUIRE(pres.getNextDeadline() == std::chrono::microseconds{10});
+    node.setNextDeadline({});
+
+    // 17 bytes are left. Refill at 100 bytes per second: 19 bytes after 20 ms is not enough, 20 bytes after 30 ms is.
+    pres.poll(std::chrono::microseconds{20'000});
+    REQUIRE(!pres.publishLogRecord(Severity::Notice, "Hello world"));
+    pres.poll(std::chrono::microseconds{30'000});
+    REQUIRE(pres.publishLogRecord(Severity::Notice, "Hello world"));
+    REQUIRE(!pres.publishLogRecord(Severity::Notice, "Hello world"));
+    REQUIRE(node.popOutput(Node::Output::LogRecordMessage));
+
+    // A long idle period does not let the budget grow beyond one longest record; the repetition suffix is appended.
+    pres.poll(std::chrono::microseconds{1'000'000'000});
+    REQUIRE(node.popOutput(Node::Output::HeartbeatMessage));
+    REQUIRE(pres.publishLogRecord(Severity::Warning, "Hello world", 123));
+    auto tr = *node.popOutput(Node::Output::LogRecordMessage);
+    REQUIRE(text_of(tr) == "Hello world (x123)");
+    REQUIRE(tr.payload.at(7) == static_cast<std::uint8_t>(Severity::Warning));
+    REQUIRE(tr.payload.at(8) == 18);
+
+    // The suffix is preserved even if the text has to be truncated.
+    pres.poll(std::chrono::microseconds{2'000'000'000});
+    REQUIRE(node.popOutput(Node::Output::HeartbeatMessage));
+    const std::string long_text(300, 'a');
+    REQUIRE(pres.publishLogRecord(Severity::Critical, long_text.c_str(), 4'294'967'295));
+    tr = *node.popOutput(Node::Output::LogRecordMessage);
+    REQUIRE(tr.payload.size() == kocherga::detail::dsdl::Diagnostic::RecordSize);
+    REQUIRE(text_of(tr) == std::string(248 - 14, 'a') + " (x4294967295)");
+    REQUIRE(!pres.publishLogRecord(Severity::Critical, "a"));  // The budget is exhausted.
+    REQUIRE(pres.getLogBudgetDeadline() == std::chrono::microseconds{2'002'570'000});
+}